@@ -0,0 +1,533 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "Asymptotics.h"
+#include "Statistics.h"
+
+typedef Asymptotics::Number Number;
+typedef Asymptotics::Complex Complex;
+typedef Asymptotics::Interval Interval;
+
+static bool isConstant(const Polynomial<Number>& a) {
+    return a.getCoefficients().size() <= 1;
+}
+
+// Polynomial::operator [] reads past the end for n equal to the number of coefficients
+static Number coefficient(const Polynomial<Number>& a, unsigned long long n) {
+    std::vector<Number> c = a.getCoefficients();
+    return n < c.size() ? c[n] : Number();
+}
+
+static Polynomial<Number> derivative(const Polynomial<Number>& a) {
+    std::vector<Number> c = a.getCoefficients();
+    std::vector<Number> result;
+    for (std::size_t i = 1; i < c.size(); ++i) {
+        result.push_back(c[i] * Number(integer((unsigned long) i)));
+    }
+    return Polynomial<Number>(result);
+}
+
+// Yun's algorithm: a = product of result[i].first^result[i].second with square-free, pairwise
+// coprime factors
+static std::vector<std::pair<Polynomial<Number>, unsigned int>> squareFreeDecomposition(const Polynomial<Number>& a) {
+    std::vector<std::pair<Polynomial<Number>, unsigned int>> result;
+    Polynomial<Number> b = Polynomial<Number>::gcd(a, derivative(a));
+    Polynomial<Number> c = a / b;
+    Polynomial<Number> d = derivative(a) / b - derivative(c);
+    for (unsigned int i = 1; !isConstant(c); ++i) {
+        Polynomial<Number> y = Polynomial<Number>::gcd(c, d);
+        if (!isConstant(y)) {
+            result.emplace_back(y, i);
+        }
+        c /= y;
+        d = d / y - derivative(c);
+    }
+    return result;
+}
+
+static int sign(const Number& a) {
+    return a > Number() ? 1 : (a < Number() ? -1 : 0);
+}
+
+static std::vector<Polynomial<Number>> sturmSequence(const Polynomial<Number>& a) {
+    std::vector<Polynomial<Number>> result = {a, derivative(a)};
+    while (!isConstant(result.back())) {
+        Polynomial<Number> r = -(result[result.size() - 2] % result.back());
+        if (r == Polynomial<Number>()) {
+            break;
+        }
+        result.push_back(r);
+    }
+    return result;
+}
+
+static int signChanges(const std::vector<Polynomial<Number>>& sequence, const Number& x) {
+    int result = 0;
+    int previous = 0;
+    for (const auto& p : sequence) {
+        int s = sign(p(x));
+        if (s != 0) {
+            if (previous != 0 && s != previous) {
+                ++result;
+            }
+            previous = s;
+        }
+    }
+    return result;
+}
+
+// interval arithmetic on exact rationals
+static Interval add(const Interval& a, const Interval& b) {
+    return {a.lower + b.lower, a.upper + b.upper};
+}
+
+static Interval multiply(const Interval& a, const Interval& b) {
+    Number p[4] = {a.lower * b.lower, a.lower * b.upper, a.upper * b.lower, a.upper * b.upper};
+    return {*std::min_element(p, p + 4), *std::max_element(p, p + 4)};
+}
+
+static bool containsZero(const Interval& a) {
+    return a.lower <= Number() && a.upper >= Number();
+}
+
+static Interval divide(const Interval& a, const Interval& b) {
+    return multiply(a, {Number(1) / b.upper, Number(1) / b.lower});
+}
+
+static Interval evaluate(const Polynomial<Number>& a, const Interval& x) {
+    std::vector<Number> c = a.getCoefficients();
+    Interval result = {Number(), Number()};
+    for (std::size_t i = c.size(); i-- > 0;) {
+        result = add(multiply(result, x), {c[i], c[i]});
+    }
+    return result;
+}
+
+static long double toLongDouble(const Number& a) {
+    // mpz_get_d would overflow for long numerators and denominators, the quotient is computed
+    // from the leading bits of both
+    long numeratorExponent, denominatorExponent;
+    double numerator = mpz_get_d_2exp(&numeratorExponent, a.getNumerator().get_mpz_t());
+    double denominator = mpz_get_d_2exp(&denominatorExponent, a.getDenominator().get_mpz_t());
+    return std::ldexp((long double) numerator / denominator, numeratorExponent - denominatorExponent);
+}
+
+static std::vector<Complex> toComplex(const Polynomial<Number>& a) {
+    std::vector<Complex> result;
+    for (const Number& c : a.getCoefficients()) {
+        result.emplace_back(toLongDouble(c), 0);
+    }
+    return result;
+}
+
+static Complex evaluate(const std::vector<Complex>& a, Complex x) {
+    Complex result = 0;
+    for (std::size_t i = a.size(); i-- > 0;) {
+        result = result * x + a[i];
+    }
+    return result;
+}
+
+// roots of a square-free polynomial by the Durand-Kerner iteration, polished by Newton steps
+static std::vector<Complex> roots(const std::vector<Complex>& a) {
+    std::size_t d = a.size() - 1;
+    std::vector<Complex> monic(a.size());
+    for (std::size_t i = 0; i <= d; ++i) {
+        monic[i] = a[i] / a[d];
+    }
+    std::vector<Complex> z(d);
+    for (std::size_t i = 0; i < d; ++i) {
+        z[i] = std::pow(Complex(0.4L, 0.9L), (long double) i);
+    }
+    for (int iteration = 0; iteration < 1000; ++iteration) {
+        long double change = 0;
+        for (std::size_t i = 0; i < d; ++i) {
+            Complex q = 1;
+            for (std::size_t j = 0; j < d; ++j) {
+                if (j != i) {
+                    q *= z[i] - z[j];
+                }
+            }
+            Complex delta = evaluate(monic, z[i]) / q;
+            z[i] -= delta;
+            change = std::max(change, std::abs(delta) / std::max(1.0L, std::abs(z[i])));
+        }
+        if (change < 1e-18L) {
+            break;
+        }
+    }
+    std::vector<Complex> da;
+    for (std::size_t i = 1; i <= d; ++i) {
+        da.push_back(monic[i] * (long double) i);
+    }
+    for (Complex& x : z) {
+        for (int iteration = 0; iteration < 3; ++iteration) {
+            Complex dx = evaluate(da, x);
+            if (std::abs(dx) > 0) {
+                x -= evaluate(monic, x) / dx;
+            }
+        }
+    }
+    return z;
+}
+
+// coefficients of a(z + h) as a polynomial in h up to h^order, by repeated synthetic division
+static std::vector<Complex> taylor(std::vector<Complex> a, Complex z, unsigned int order) {
+    std::vector<Complex> result;
+    for (unsigned int k = 0; k <= order; ++k) {
+        if (a.empty()) {
+            result.emplace_back(0);
+            continue;
+        }
+        std::vector<Complex> quotient(a.size() - 1);
+        Complex r = a.back();
+        for (std::size_t i = a.size() - 1; i-- > 0;) {
+            quotient[i] = r;
+            r = r * z + a[i];
+        }
+        result.push_back(r);
+        a = quotient;
+    }
+    return result;
+}
+
+// a / (x - z)
+static std::vector<Complex> deflate(const std::vector<Complex>& a, Complex z) {
+    std::vector<Complex> quotient(a.size() - 1);
+    Complex r = a.back();
+    for (std::size_t i = a.size() - 1; i-- > 0;) {
+        quotient[i] = r;
+        r = r * z + a[i];
+    }
+    return quotient;
+}
+
+// smallest positive root of a square-free polynomial with a(0) != 0, refined to the given width
+struct PositiveRoot {
+    std::vector<Polynomial<Number>> sturm;
+    Interval interval;
+    bool exists;
+
+    PositiveRoot(const Polynomial<Number>& a, const Number& width) {
+        this->sturm = sturmSequence(a);
+        std::vector<Number> c = a.getCoefficients();
+        Number bound(1);
+        for (const Number& x : c) {
+            Number q = x / c.back();
+            bound = std::max(bound, Number(1) + (q < Number() ? -q : q));
+        }
+        this->interval = {Number(), bound};
+        this->exists = this->count(Number(), bound) > 0;
+        if (this->exists) {
+            this->refine(width);
+        }
+    }
+
+    int count(const Number& lower, const Number& upper) const {
+        return signChanges(this->sturm, lower) - signChanges(this->sturm, upper);
+    }
+
+    void refine(const Number& width) {
+        while (this->interval.upper - this->interval.lower > width || this->count(this->interval.lower, this->interval.upper) > 1) {
+            Number middle = (this->interval.lower + this->interval.upper) / Number(2);
+            if (this->count(this->interval.lower, middle) > 0) {
+                this->interval.upper = middle;
+            } else {
+                this->interval.lower = middle;
+            }
+        }
+    }
+};
+
+Asymptotics::Asymptotics(const ExtendedRationalFunction<integer>& f, unsigned int precision) {
+    STATISTICS_TIMER("asymptotics");
+    this->rest = f.getRest();
+    Polynomial<Number> numerator = f.getNumerator();
+    std::vector<std::pair<Polynomial<Number>, unsigned int>> factors;
+    Polynomial<Number> denominator({Number(1)});
+    Polynomial<Number> original({Number(1)});
+    for (const auto& p : f.getDenominator()) {
+        for (unsigned int i = 0; i < p.second; ++i) {
+            original *= p.first;
+        }
+        for (const auto& q : squareFreeDecomposition(p.first)) {
+            factors.emplace_back(q.first, q.second * p.second);
+            for (unsigned int i = 0; i < q.second * p.second; ++i) {
+                denominator *= q.first;
+            }
+        }
+    }
+    // the square-free factors are monic, the constant they lose goes to the numerator
+    numerator /= original / denominator;
+    if (factors.empty() || numerator == Polynomial<Number>()) {
+        this->rest += numerator;
+        return;
+    }
+    this->finite = false;
+
+    // the coprime factors have different roots, so refining the smallest positive root of each
+    // eventually separates the smallest one
+    Number width = Number(1) / Number(integer(1) << precision);
+    std::vector<PositiveRoot> positiveRoots;
+    for (const auto& p : factors) {
+        positiveRoots.emplace_back(p.first, width);
+    }
+    int smallest;
+    while (true) {
+        smallest = -1;
+        for (int i = 0; i < (int) positiveRoots.size(); ++i) {
+            if (positiveRoots[i].exists && (smallest == -1 || positiveRoots[i].interval.lower < positiveRoots[smallest].interval.lower)) {
+                smallest = i;
+            }
+        }
+        bool separated = true;
+        for (int i = 0; i < (int) positiveRoots.size(); ++i) {
+            if (i != smallest && positiveRoots[i].exists && positiveRoots[i].interval.lower <= positiveRoots[smallest].interval.upper) {
+                separated = false;
+                positiveRoots[i].refine((positiveRoots[i].interval.upper - positiveRoots[i].interval.lower) / Number(2));
+            }
+        }
+        if (separated) {
+            break;
+        }
+        positiveRoots[smallest].refine((positiveRoots[smallest].interval.upper - positiveRoots[smallest].interval.lower) / Number(2));
+    }
+    // a rational function with nonnegative coefficients has a pole at its radius of convergence
+    this->radius = positiveRoots[smallest].interval;
+    unsigned int m = factors[smallest].second;
+
+    // C = m * P(ρ) / (Q^(m)(ρ) * (-ρ)^m), refined until the interval does not contain 0
+    Polynomial<Number> qm = denominator;
+    for (unsigned int i = 0; i < m; ++i) {
+        qm = derivative(qm);
+    }
+    while (true) {
+        Interval minusRadiusPower = {Number(1), Number(1)};
+        for (unsigned int i = 0; i < m; ++i) {
+            minusRadiusPower = multiply(minusRadiusPower, {-this->radius.upper, -this->radius.lower});
+        }
+        Interval divisor = multiply(evaluate(qm, this->radius), minusRadiusPower);
+        if (!containsZero(divisor)) {
+            Interval p = evaluate(numerator, this->radius);
+            this->constant = divide(multiply(p, {Number(integer(m)), Number(integer(m))}), divisor);
+            if (!containsZero(this->constant)) {
+                break;
+            }
+        }
+        positiveRoots[smallest].refine((this->radius.upper - this->radius.lower) / Number(2));
+        this->radius = positiveRoots[smallest].interval;
+    }
+    this->logRadius = std::log((toLongDouble(this->radius.lower) + toLongDouble(this->radius.upper)) / 2);
+
+    // numeric partial fractions: for a pole z of multiplicity m, Q = (x - z)^m R and the Taylor
+    // coefficients g_k of P / R at z give c_{z,j} = g_{m-j} * (-z)^(-j)
+    std::vector<Complex> p = toComplex(numerator);
+    std::vector<Complex> q = toComplex(denominator);
+    long double rho = std::exp(this->logRadius);
+    for (const auto& factor : factors) {
+        for (Complex z : roots(toComplex(factor.first))) {
+            unsigned int mz = factor.second;
+            std::vector<Complex> r = q;
+            for (unsigned int i = 0; i < mz; ++i) {
+                r = deflate(r, z);
+            }
+            std::vector<Complex> ps = taylor(p, z, mz - 1);
+            std::vector<Complex> rs = taylor(r, z, mz - 1);
+            std::vector<Complex> g(mz);
+            for (unsigned int k = 0; k < mz; ++k) {
+                Complex s = ps[k];
+                for (unsigned int i = 1; i <= k; ++i) {
+                    s -= rs[i] * g[k - i];
+                }
+                g[k] = s / rs[0];
+            }
+            bool dominant = this->isDominant(z);
+            for (unsigned int j = 1; j <= mz; ++j) {
+                Term term = {z, j, g[mz - j] * std::pow(-z, -(long double) j)};
+                if (dominant && j == mz && mz >= m) {
+                    if (mz > m) {
+                        // cannot happen for nonnegative coefficients, kept for robustness
+                        this->otherTerms.insert(this->otherTerms.end(), this->mainTerms.begin(), this->mainTerms.end());
+                        this->mainTerms.clear();
+                        m = mz;
+                    }
+                    this->mainTerms.push_back(term);
+                } else {
+                    this->otherTerms.push_back(term);
+                }
+            }
+        }
+    }
+    this->multiplicity = m;
+    this->numberOfDominantPoles = this->mainTerms.size();
+}
+
+bool Asymptotics::isFinite() const {
+    return this->finite;
+}
+
+const Asymptotics::Interval& Asymptotics::getRadius() const {
+    return this->radius;
+}
+
+const Asymptotics::Interval& Asymptotics::getConstant() const {
+    return this->constant;
+}
+
+unsigned int Asymptotics::getPolynomialDegree() const {
+    return this->multiplicity - 1;
+}
+
+unsigned int Asymptotics::getNumberOfDominantPoles() const {
+    return this->numberOfDominantPoles;
+}
+
+bool Asymptotics::isDominant(const Complex& pole) const {
+    long double rho = std::exp(this->logRadius);
+    return std::abs(std::abs(pole) - rho) <= 1e-12L * rho;
+}
+
+unsigned int Asymptotics::getOrder(const Complex& pole) {
+    // the phase of the pole as a fraction of a turn, its denominator is the order
+    const long double pi = std::acos(-1.0L);
+    long double turns = std::arg(pole) / (2 * pi);
+    for (unsigned int order = 1; order <= MAXIMUM_PERIOD; ++order) {
+        if (std::fabs(turns * order - std::round(turns * order)) <= 1e-6L) {
+            return order;
+        }
+    }
+    return 0;
+}
+
+unsigned int Asymptotics::getPeriod() const {
+    // every pole has a term of power 1, so these list each dominant pole once
+    std::vector<Complex> poles;
+    for (const std::vector<Term>* terms : {&this->mainTerms, &this->otherTerms}) {
+        for (const Term& term : *terms) {
+            if (term.power == 1 && this->isDominant(term.pole)) {
+                poles.push_back(term.pole);
+            }
+        }
+    }
+    unsigned int result = 1;
+    for (const Complex& pole : poles) {
+        unsigned int order = getOrder(pole);
+        if (order == 0) {
+            // not recognized numerically, all the dominant poles are taken as a full set of roots
+            order = poles.size();
+        }
+        result = std::lcm(result, order);
+        if (result >= MAXIMUM_PERIOD) {
+            return MAXIMUM_PERIOD;
+        }
+    }
+    return result;
+}
+
+long double Asymptotics::getGrowthRate() const {
+    return this->finite ? 0 : std::exp(-this->logRadius);
+}
+
+long double Asymptotics::getEntropyRate() const {
+    return this->finite ? 0 : -this->logRadius / std::log(2.0L);
+}
+
+// log2 C(n + power - 1, power - 1)
+long double Asymptotics::log2Binomial(unsigned long long n, unsigned int power) const {
+    // C(n+power-1, power-1) = prod (n+i)/i, summed term by term since differences of lgamma lose
+    // the precision needed for large n
+    long double result = 0;
+    for (unsigned int i = 1; i < power; ++i) {
+        result += std::log2(((long double) n + i) / i);
+    }
+    return result;
+}
+
+long double Asymptotics::getEntropy(unsigned long long n) const {
+    if (this->finite) {
+        return std::log2(std::fabs(toLongDouble(coefficient(this->rest, n))));
+    }
+    // the dominant poles have modulus ρ, so only their phases are left after factoring ρ^(-n) out
+    Complex sum = 0;
+    for (const Term& term : this->mainTerms) {
+        sum += term.coefficient * std::exp((long double) n * (Complex(this->logRadius) - std::log(term.pole)));
+    }
+    long double polynomialPart = toLongDouble(coefficient(this->rest, n));
+    long double log2Main = this->log2Binomial(n, this->multiplicity) - n * this->logRadius / std::log(2.0L) + std::log2(std::fabs(sum.real()));
+    if (polynomialPart != 0) {
+        return std::log2(std::fabs(std::exp2(log2Main) + polynomialPart));
+    }
+    return log2Main;
+}
+
+long double Asymptotics::approximate(unsigned long long n) const {
+    long double entropy = this->getEntropy(n);
+    return std::isinf(entropy) && entropy < 0 ? 0 : std::exp2(entropy);
+}
+
+long double Asymptotics::getLog2MonotoneBound(unsigned long long n) const {
+    // every term is bounded by |c| * C(n+j-1, j-1) * min(1, |z|)^(-n), which grows with n
+    long double maximum = -INFINITY;
+    std::vector<long double> logs;
+    for (const std::vector<Term>* terms : {&this->mainTerms, &this->otherTerms}) {
+        for (const Term& term : *terms) {
+            long double l = std::log2(std::abs(term.coefficient)) + this->log2Binomial(n, term.power) - n * std::log2(std::min(1.0L, std::abs(term.pole)));
+            logs.push_back(l);
+            maximum = std::max(maximum, l);
+        }
+    }
+    if (std::isinf(maximum)) {
+        return maximum;
+    }
+    long double sum = 0;
+    for (long double l : logs) {
+        sum += std::exp2(l - maximum);
+    }
+    return maximum + std::log2(sum);
+}
+
+long double Asymptotics::getScaledDominantPart(unsigned long long n) const {
+    if (this->finite) {
+        return 0;
+    }
+    Complex sum = 0;
+    long double magnitude = 0;
+    for (const std::vector<Term>* terms : {&this->mainTerms, &this->otherTerms}) {
+        for (const Term& term : *terms) {
+            if (!this->isDominant(term.pole)) {
+                continue;
+            }
+            // (ρ / z)^n is a root of unity, its exponent is reduced modulo the order when it is
+            // known, so that the phase stays exact for large n
+            unsigned int order = getOrder(term.pole);
+            Complex phase = order > 0 ? std::polar(1.0L, -std::arg(term.pole) * (long double) (n % order))
+                                      : std::exp((long double) n * (Complex(this->logRadius) - std::log(term.pole)));
+            Complex value = term.coefficient * std::exp2(this->log2Binomial(n, term.power)) * phase;
+            sum += value;
+            magnitude += std::abs(value);
+        }
+    }
+    // terms cancelling out, e.g. in the classes of odd lengths of (aa)*, leave rounding errors only
+    return std::fabs(sum.real()) <= 1e-12L * magnitude ? 0 : sum.real();
+}
+
+long double Asymptotics::getScaledOuterErrorBound(unsigned long long n) const {
+    long double result = 0;
+    for (const std::vector<Term>* terms : {&this->mainTerms, &this->otherTerms}) {
+        for (const Term& term : *terms) {
+            if (!this->isDominant(term.pole)) {
+                result += std::exp2(std::log2(std::abs(term.coefficient)) + this->log2Binomial(n, term.power)
+                                    + n * (this->logRadius - std::log(std::abs(term.pole))) / std::log(2.0L));
+            }
+        }
+    }
+    return result;
+}
+
+long double Asymptotics::getErrorBound(unsigned long long n) const {
+    long double result = 0;
+    for (const Term& term : this->otherTerms) {
+        result += std::exp2(std::log2(std::abs(term.coefficient)) + this->log2Binomial(n, term.power) - n * std::log2(std::abs(term.pole)));
+    }
+    return result;
+}
@@ -0,0 +1,86 @@
+#ifndef ASYMPTOTICS_H
+#define ASYMPTOTICS_H
+
+#include <complex>
+#include <vector>
+#include "DFA.h"
+#include "Polynomial.h"
+#include "Rational.h"
+#include "ExtendedRationalFunction.h"
+
+// Asymptotic number of words of length n, a_n ≈ C * n^k * ρ^(-n), read from the poles of the
+// generating function. The denominator factors separated by ExtendedRationalFunction are split
+// into square-free parts (Yun), the smallest positive root ρ is isolated exactly with Sturm
+// sequences and bisection, and C is evaluated in rational interval arithmetic, so both are
+// certified intervals. k + 1 is the multiplicity of ρ.
+//
+// All the other poles are found numerically (Durand-Kerner on the square-free parts) to get
+// the full partial fraction decomposition
+//     a_n = rest_n + sum over poles z and j <= multiplicity of z of c_{z,j} * C(n+j-1, j-1) * z^(-n).
+// The terms of the poles on the circle |z| = ρ with the highest multiplicity make the
+// approximation, which also covers periodic languages with several dominant poles; the sum of
+// absolute values of the remaining terms is the error bound. These two are in long double.
+class Asymptotics {
+public:
+    typedef Rational<integer> Number;
+    typedef std::complex<long double> Complex;
+    static const unsigned int MAXIMUM_PERIOD = 1024;
+    struct Interval {
+        Number lower;
+        Number upper;
+    };
+    struct Term {
+        Complex pole;
+        unsigned int power;
+        Complex coefficient;
+    };
+private:
+    Polynomial<Number> rest;
+    bool finite = true;
+    Interval radius;
+    Interval constant;
+    unsigned int multiplicity = 0;
+    unsigned int numberOfDominantPoles = 0;
+    long double logRadius = 0;
+    std::vector<Term> mainTerms;
+    std::vector<Term> otherTerms;
+    long double log2Binomial(unsigned long long n, unsigned int power) const;
+    // true for the poles on the circle |z| = ρ, whatever their multiplicity
+    bool isDominant(const Complex& pole) const;
+    // the order of pole / |pole| as a root of unity, 0 if it is not recognized
+    static unsigned int getOrder(const Complex& pole);
+public:
+    explicit Asymptotics(const ExtendedRationalFunction<integer>& f, unsigned int precision = 64);
+    // true if the language is finite, then there are no poles and the counts are exact
+    bool isFinite() const;
+    // ρ, the radius of convergence of the generating function
+    const Interval& getRadius() const;
+    // C in C * n^k * ρ^(-n), from the pole at ρ only
+    const Interval& getConstant() const;
+    // k in C * n^k * ρ^(-n)
+    unsigned int getPolynomialDegree() const;
+    // number of poles on the circle |z| = ρ with the highest multiplicity, more than one for
+    // periodic languages
+    unsigned int getNumberOfDominantPoles() const;
+    // the poles on the circle |z| = ρ are ρ times roots of unity, the period is the lcm of their
+    // orders, including the poles of lower multiplicity; along every residue class modulo it the
+    // terms of these poles are ρ^(-n) times a polynomial in n
+    unsigned int getPeriod() const;
+    // 1 / ρ
+    long double getGrowthRate() const;
+    // log2(1 / ρ), bits of entropy per symbol
+    long double getEntropyRate() const;
+    // log2 of the approximate number of words of length n
+    long double getEntropy(unsigned long long n) const;
+    long double approximate(unsigned long long n) const;
+    // bound on |a_n - approximate(n)|
+    long double getErrorBound(unsigned long long n) const;
+    // the terms of all the poles on |z| = ρ times ρ^n
+    long double getScaledDominantPart(unsigned long long n) const;
+    // bound on the sum of the terms of the poles with |z| > ρ times ρ^n
+    long double getScaledOuterErrorBound(unsigned long long n) const;
+    // log2 of a bound on |a_n - rest_n| that does not decrease with n, -inf for finite languages
+    long double getLog2MonotoneBound(unsigned long long n) const;
+};
+
+#endif //ASYMPTOTICS_H
@@ -0,0 +1,143 @@
+#include <map>
+#include "BitParallelNFA.h"
+#include "Statistics.h"
+
+BitParallelNFA::BitParallelNFA(NFA* nfa) {
+    STATISTICS_TIMER("bitParallelNFA");
+    std::vector<NFA*> states = nfa->getStates();
+
+    // copy 0 is the start state entered by no symbol, then a copy for every (state, symbol)
+    // such that the state has an incoming transition labelled with the symbol
+    std::vector<std::map<char, unsigned int>> copies(states.size());
+    std::vector<std::pair<NFA*, char>> copyStates = {{states[0], '\0'}};
+    for (NFA* q : states) {
+        for (const auto& p : q->getTransitions()) {
+            for (NFA* r : p.second) {
+                if (copies[r->getIndex()].emplace(p.first, copyStates.size()).second) {
+                    copyStates.emplace_back(r, p.first);
+                }
+            }
+        }
+    }
+    this->numberOfStates = copyStates.size();
+    this->numberOfWords = (this->numberOfStates + 63) / 64;
+    unsigned int w = this->numberOfWords;
+    this->entered.assign(256 * w, 0);
+    this->accept.assign(w, 0);
+    this->successors.resize(this->numberOfStates);
+    for (unsigned int i = 0; i < this->numberOfStates; ++i) {
+        NFA* q = copyStates[i].first;
+        if (i > 0) {
+            this->entered[(unsigned char) copyStates[i].second * w + i / 64] |= (Word) 1 << (i % 64);
+        }
+        if (q->isAcceptable()) {
+            this->accept[i / 64] |= (Word) 1 << (i % 64);
+        }
+        for (const auto& p : q->getTransitions()) {
+            for (NFA* r : p.second) {
+                this->successors[i].push_back(copies[r->getIndex()][p.first]);
+            }
+        }
+    }
+
+    if (this->numberOfStates <= MAXIMUM_STATES_FOR_TABLES) {
+        unsigned int numberOfChunks = (this->numberOfStates + 7) / 8;
+        this->followTables.assign((std::size_t) numberOfChunks * 256 * w, 0);
+        for (unsigned int chunk = 0; chunk < numberOfChunks; ++chunk) {
+            Word* table = this->followTables.data() + (std::size_t) chunk * 256 * w;
+            // the row of a byte is the row without its lowest bit plus the successors of that bit
+            for (unsigned int bits = 1; bits < 256; ++bits) {
+                unsigned int lowest = __builtin_ctz(bits);
+                Word* row = table + bits * w;
+                const Word* rest = table + (bits & (bits - 1)) * w;
+                for (unsigned int j = 0; j < w; ++j) {
+                    row[j] = rest[j];
+                }
+                unsigned int state = 8 * chunk + lowest;
+                if (state < this->numberOfStates) {
+                    for (unsigned int r : this->successors[state]) {
+                        row[r / 64] |= (Word) 1 << (r % 64);
+                    }
+                }
+            }
+        }
+    }
+    STATISTICS_SET("bit_parallel_nfa.states", this->numberOfStates);
+}
+
+void BitParallelNFA::follow(const Word* current, Word* next) const {
+    unsigned int w = this->numberOfWords;
+    for (unsigned int j = 0; j < w; ++j) {
+        next[j] = 0;
+    }
+    if (!this->followTables.empty()) {
+        for (unsigned int i = 0; i < w; ++i) {
+            Word word = current[i];
+            for (unsigned int k = 0; word != 0; ++k, word >>= 8) {
+                unsigned int bits = word & 0xff;
+                if (bits != 0) {
+                    const Word* row = this->followTables.data() + ((std::size_t) (8 * i + k) * 256 + bits) * w;
+                    for (unsigned int j = 0; j < w; ++j) {
+                        next[j] |= row[j];
+                    }
+                }
+            }
+        }
+    } else {
+        for (unsigned int i = 0; i < w; ++i) {
+            for (Word word = current[i]; word != 0; word &= word - 1) {
+                for (unsigned int r : this->successors[64 * i + __builtin_ctzll(word)]) {
+                    next[r / 64] |= (Word) 1 << (r % 64);
+                }
+            }
+        }
+    }
+}
+
+unsigned int BitParallelNFA::getNumberOfStates() const {
+    return this->numberOfStates;
+}
+
+unsigned int BitParallelNFA::getNumberOfWords() const {
+    return this->numberOfWords;
+}
+
+void BitParallelNFA::getStartSet(Word* states) const {
+    for (unsigned int j = 0; j < this->numberOfWords; ++j) {
+        states[j] = 0;
+    }
+    states[0] = 1;
+}
+
+bool BitParallelNFA::step(const Word* current, char symbol, Word* next) const {
+    unsigned int w = this->numberOfWords;
+    this->follow(current, next);
+    const Word* mask = this->entered.data() + (unsigned char) symbol * w;
+    Word any = 0;
+    for (unsigned int j = 0; j < w; ++j) {
+        next[j] &= mask[j];
+        any |= next[j];
+    }
+    return any != 0;
+}
+
+bool BitParallelNFA::isAcceptable(const Word* states) const {
+    for (unsigned int j = 0; j < this->numberOfWords; ++j) {
+        if ((states[j] & this->accept[j]) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BitParallelNFA::regexMatch(const std::string& word) const {
+    std::vector<Word> current(this->numberOfWords), next(this->numberOfWords);
+    this->getStartSet(current.data());
+    for (char c : word) {
+        if (!this->step(current.data(), c, next.data())) {
+            return false;
+        }
+        current.swap(next);
+    }
+    return this->isAcceptable(current.data());
+}
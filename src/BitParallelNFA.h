@@ -0,0 +1,48 @@
+#ifndef BIT_PARALLEL_NFA_H
+#define BIT_PARALLEL_NFA_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "NFA.h"
+
+// Simulation of an ε-free NFA with sets of states kept as bit vectors of 64-bit words.
+// The automaton is first made homogeneous (Glushkov-like): every state is split into copies,
+// one per symbol of its incoming transitions, so all transitions into a copy have the same
+// symbol. Then a step is next = follow(current) & entered[symbol], where follow is the union
+// of successors regardless of the symbol. For m copies and words of w = 64 bits:
+//  - up to MAXIMUM_STATES_FOR_TABLES copies follow is read from tables indexed by bytes of the
+//    current set, m/8 rows of m/w words, so a symbol costs O(m^2/(8w)) word operations;
+//  - for larger automata the successors of the active states are ORed one by one, so a symbol
+//    costs O(m/w) plus the number of transitions leaving the active states, up to O(m^2).
+// Neither is the O(m/w) of Shift-And, which relies on the positions of a single pattern being
+// linearly ordered; an arbitrary NFA has no such order. Matching takes no time or memory
+// exponential in the size of the NFA.
+class BitParallelNFA {
+public:
+    typedef std::uint64_t Word;
+    static const unsigned int MAXIMUM_STATES_FOR_TABLES = 1024;
+private:
+    unsigned int numberOfStates;
+    unsigned int numberOfWords;
+    // states entered by each symbol, 256 rows of numberOfWords words
+    std::vector<Word> entered;
+    std::vector<Word> accept;
+    // row (8 * chunk + bits of the chunk) holds the union of successors of the set bits
+    std::vector<Word> followTables;
+    std::vector<std::vector<unsigned int>> successors;
+    void follow(const Word* current, Word* next) const;
+public:
+    // nfa has to be ε-free, see NFA::removeEpsilonTransitions
+    explicit BitParallelNFA(NFA* nfa);
+    unsigned int getNumberOfStates() const;
+    unsigned int getNumberOfWords() const;
+    // the start set is the single state 0
+    void getStartSet(Word* states) const;
+    // sets next to the states reached from current by symbol, returns false if there are none
+    bool step(const Word* current, char symbol, Word* next) const;
+    bool isAcceptable(const Word* states) const;
+    bool regexMatch(const std::string& word) const;
+};
+
+#endif //BIT_PARALLEL_NFA_H
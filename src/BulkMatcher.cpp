@@ -0,0 +1,122 @@
+#include <cstring>
+#include "BulkMatcher.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "Statistics.h"
+
+BulkMatcher::BulkMatcher(const CompiledDFA& _dfa) : dfa(_dfa) {}
+
+std::size_t BulkMatcher::getLineBoundary(const char* data, std::size_t size, std::size_t position) {
+    if (position == 0 || position >= size) {
+        return std::min(position, size);
+    }
+    const void* newline = std::memchr(data + position - 1, '\n', size - position + 1);
+    return newline == nullptr ? size : static_cast<const char*>(newline) - data + 1;
+}
+
+template <bool offsets>
+void BulkMatcher::match(const char* data, std::size_t begin, std::size_t end, unsigned long long& count, std::vector<std::uint64_t>& result) const {
+    const std::uint32_t* transitions = this->dfa.getTransitionTable();
+    std::size_t numberOfColumns = this->dfa.getNumberOfColumns();
+    std::uint32_t startState = this->dfa.getStartState();
+    // lanes work on consecutive parts of the range, their results are merged in order
+    std::size_t position[LANES], laneEnd[LANES], lineBegin[LANES];
+    std::uint32_t state[LANES], previous[LANES];
+    std::vector<std::uint64_t> laneResults[LANES];
+    for (unsigned int l = 0; l < LANES; ++l) {
+        position[l] = getLineBoundary(data, end, begin + (end - begin) * l / LANES);
+        lineBegin[l] = position[l];
+        state[l] = startState;
+        previous[l] = startState;
+    }
+    for (unsigned int l = 0; l < LANES; ++l) {
+        laneEnd[l] = l + 1 < LANES ? position[l + 1] : end;
+    }
+    unsigned long long matches = 0;
+    auto finish = [&](unsigned int l, std::size_t lineEnd) {
+        // the state before the last symbol is kept, so a trailing '\r' costs no second pass
+        bool carriageReturn = lineEnd > lineBegin[l] && data[lineEnd - 1] == '\r';
+        if (this->dfa.isAcceptable(carriageReturn ? previous[l] : state[l])) {
+            ++matches;
+            if (offsets) {
+                laneResults[l].push_back(lineBegin[l]);
+            }
+        }
+    };
+    unsigned int active = LANES;
+    while (active > 0) {
+        active = 0;
+        for (unsigned int l = 0; l < LANES; ++l) {
+            if (position[l] >= laneEnd[l]) {
+                continue;
+            }
+            ++active;
+            char c = data[position[l]];
+            if (c == '\n') {
+                finish(l, position[l]);
+                state[l] = startState;
+                lineBegin[l] = position[l] + 1;
+            } else {
+                previous[l] = state[l];
+                state[l] = transitions[state[l] * numberOfColumns + this->dfa.getColumn(c)];
+            }
+            ++position[l];
+            if (position[l] == laneEnd[l] && lineBegin[l] < laneEnd[l]) {
+                // the last line of the input has no newline
+                finish(l, laneEnd[l]);
+            }
+        }
+    }
+    count += matches;
+    if (offsets) {
+        for (unsigned int l = 0; l < LANES; ++l) {
+            result.insert(result.end(), laneResults[l].begin(), laneResults[l].end());
+        }
+    }
+}
+
+template <bool offsets>
+void BulkMatcher::match(const char* data, std::size_t size, unsigned int numberOfThreads, unsigned long long& count, std::vector<std::uint64_t>& result) const {
+    STATISTICS_TIMER("bulkMatch");
+    STATISTICS_ADD("bulk_match.bytes", size);
+    std::vector<std::size_t> bounds(numberOfThreads + 1);
+    for (unsigned int t = 0; t <= numberOfThreads; ++t) {
+        bounds[t] = getLineBoundary(data, size, size * t / numberOfThreads);
+    }
+    std::vector<unsigned long long> counts(numberOfThreads, 0);
+    std::vector<std::vector<std::uint64_t>> results(numberOfThreads);
+    Parallel::run(numberOfThreads, [&](unsigned int t) {
+        this->match<offsets>(data, bounds[t], bounds[t + 1], counts[t], results[t]);
+    });
+    for (unsigned int t = 0; t < numberOfThreads; ++t) {
+        count += counts[t];
+        if (offsets) {
+            result.insert(result.end(), results[t].begin(), results[t].end());
+        }
+    }
+    STATISTICS_ADD("bulk_match.matches", count);
+}
+
+unsigned long long BulkMatcher::count(const char* data, std::size_t size, unsigned int numberOfThreads) const {
+    unsigned long long result = 0;
+    std::vector<std::uint64_t> unused;
+    this->match<false>(data, size, numberOfThreads, result, unused);
+    return result;
+}
+
+unsigned long long BulkMatcher::countFile(const std::string& path, unsigned int numberOfThreads) const {
+    MappedFile file(path);
+    return this->count(file.getData(), file.getSize(), numberOfThreads);
+}
+
+std::vector<std::uint64_t> BulkMatcher::find(const char* data, std::size_t size, unsigned int numberOfThreads) const {
+    unsigned long long count = 0;
+    std::vector<std::uint64_t> result;
+    this->match<true>(data, size, numberOfThreads, count, result);
+    return result;
+}
+
+std::vector<std::uint64_t> BulkMatcher::findInFile(const std::string& path, unsigned int numberOfThreads) const {
+    MappedFile file(path);
+    return this->find(file.getData(), file.getSize(), numberOfThreads);
+}
@@ -0,0 +1,37 @@
+#ifndef BULK_MATCHER_H
+#define BULK_MATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CompiledDFA.h"
+
+// Membership test of every line of a newline separated word list, e.g. checking leaked
+// passwords against a policy. The input is split into ranges starting at line boundaries, one
+// per thread, and every thread walks LANES lines at a time through the transition table of a
+// CompiledDFA, so that the loads of independent words overlap. A trailing '\r' of a line is
+// ignored. Words are never copied; offsets of matching lines are the only output.
+class BulkMatcher {
+public:
+    static const unsigned int LANES = 4;
+private:
+    const CompiledDFA& dfa;
+    template <bool offsets>
+    void match(const char* data, std::size_t begin, std::size_t end, unsigned long long& count, std::vector<std::uint64_t>& result) const;
+    template <bool offsets>
+    void match(const char* data, std::size_t size, unsigned int numberOfThreads, unsigned long long& count, std::vector<std::uint64_t>& result) const;
+public:
+    explicit BulkMatcher(const CompiledDFA& dfa);
+    // first position after the line containing position - 1, so that ranges split at such
+    // positions start at line boundaries
+    static std::size_t getLineBoundary(const char* data, std::size_t size, std::size_t position);
+    // number of matching lines
+    unsigned long long count(const char* data, std::size_t size, unsigned int numberOfThreads) const;
+    unsigned long long countFile(const std::string& path, unsigned int numberOfThreads) const;
+    // offsets of the first characters of the matching lines, in increasing order
+    std::vector<std::uint64_t> find(const char* data, std::size_t size, unsigned int numberOfThreads) const;
+    std::vector<std::uint64_t> findInFile(const std::string& path, unsigned int numberOfThreads) const;
+};
+
+#endif //BULK_MATCHER_H
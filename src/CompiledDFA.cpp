@@ -0,0 +1,212 @@
+#include <cstring>
+#include <fstream>
+#include "CompiledDFA.h"
+#include "MatrixInversion.h"
+#include "InvalidFileException.h"
+#include "Statistics.h"
+
+static const char MAGIC[8] = {'C', 'F', 'L', 'D', 'F', 'A', '\0', '\0'};
+static const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+static std::uint64_t align(std::uint64_t offset) {
+    return (offset + 63) & ~(std::uint64_t) 63;
+}
+
+CompiledDFA::CompiledDFA(DFA* dfa) {
+    std::vector<DFA*> states = dfa->getCanonicalStates();
+    std::uint32_t n = states.size();
+
+    // only transitions between canonical states are kept, the rest lead to the dead state
+    auto isCanonical = [&states](DFA* q) {
+        return q->getIndex() >= 0 && q->getIndex() < states.size() && states[q->getIndex()] == q;
+    };
+    bool usedSymbols[256] = {};
+    for (DFA* state : states) {
+        for (const auto& p : state->getTransitions()) {
+            if (isCanonical(p.second)) {
+                usedSymbols[(unsigned char) p.first] = true;
+            }
+        }
+    }
+    std::string alphabetSymbols;
+    for (int c = 0; c < 256; ++c) {
+        if (usedSymbols[c]) {
+            alphabetSymbols.push_back((char) c);
+        }
+    }
+    std::uint32_t numberOfColumns = alphabetSymbols.size() + 1;
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.byteOrder = BYTE_ORDER_MARK;
+    h.numberOfStates = n;
+    h.numberOfColumns = numberOfColumns;
+    h.startState = 0;
+    h.alphabetOffset = align(sizeof(Header));
+    h.symbolsOffset = align(h.alphabetOffset + 256);
+    h.transitionsOffset = align(h.symbolsOffset + numberOfColumns);
+    h.acceptOffset = align(h.transitionsOffset + (std::uint64_t) (n + 1) * numberOfColumns * sizeof(std::uint32_t));
+    h.size = align(h.acceptOffset + (n / 64 + 1) * sizeof(std::uint64_t));
+
+    this->buffer.assign(h.size / sizeof(std::uint64_t), 0);
+    char* image = reinterpret_cast<char*>(this->buffer.data());
+    std::memcpy(image, &h, sizeof(h));
+    auto* _alphabet = reinterpret_cast<std::uint8_t*>(image + h.alphabetOffset);
+    std::memset(_alphabet, numberOfColumns - 1, 256);
+    for (std::uint32_t i = 0; i < alphabetSymbols.size(); ++i) {
+        _alphabet[(unsigned char) alphabetSymbols[i]] = i;
+    }
+    std::memcpy(image + h.symbolsOffset, alphabetSymbols.data(), alphabetSymbols.size());
+    auto* _transitions = reinterpret_cast<std::uint32_t*>(image + h.transitionsOffset);
+    for (std::uint64_t i = 0; i < (std::uint64_t) (n + 1) * numberOfColumns; ++i) {
+        _transitions[i] = n;
+    }
+    auto* _accept = reinterpret_cast<std::uint64_t*>(image + h.acceptOffset);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        for (const auto& p : states[i]->getTransitions()) {
+            if (isCanonical(p.second)) {
+                _transitions[(std::size_t) i * numberOfColumns + _alphabet[(unsigned char) p.first]] = p.second->getIndex();
+            }
+        }
+        if (states[i]->isAcceptable()) {
+            _accept[i >> 6] |= (std::uint64_t) 1 << (i & 63);
+        }
+    }
+    this->attach(image, h.size);
+}
+
+CompiledDFA::CompiledDFA(const std::string& path) {
+    this->file.reset(new MappedFile(path));
+    this->attach(this->file->getData(), this->file->getSize());
+}
+
+void CompiledDFA::attach(const char* image, std::size_t size) {
+    if (size < sizeof(Header)) {
+        throw InvalidFileException();
+    }
+    const auto* h = reinterpret_cast<const Header*>(image);
+    // a section fits if it neither starts nor ends beyond the image, checked without overflow
+    auto fits = [h](std::uint64_t offset, std::uint64_t length) {
+        return offset <= h->size && length <= h->size - offset;
+    };
+    if (std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION || h->byteOrder != BYTE_ORDER_MARK
+        || h->numberOfColumns == 0 || h->numberOfColumns > 256 || h->size > size || h->numberOfStates == UINT32_MAX
+        || (h->numberOfStates == 0 ? h->startState != 0 : h->startState >= h->numberOfStates) || !fits(h->alphabetOffset, 256)
+        || !fits(h->symbolsOffset, h->numberOfColumns)
+        || !fits(h->transitionsOffset, ((std::uint64_t) h->numberOfStates + 1) * h->numberOfColumns * sizeof(std::uint32_t))
+        || !fits(h->acceptOffset, ((std::uint64_t) h->numberOfStates / 64 + 1) * sizeof(std::uint64_t))
+        || (h->transitionsOffset | h->acceptOffset) % 8 != 0) {
+        throw InvalidFileException();
+    }
+    // the contents are checked once here, so that the accessors, which do not check anything,
+    // stay within the image whatever the file contains
+    const auto* _alphabet = reinterpret_cast<const std::uint8_t*>(image + h->alphabetOffset);
+    for (int c = 0; c < 256; ++c) {
+        if (_alphabet[c] >= h->numberOfColumns) {
+            throw InvalidFileException();
+        }
+    }
+    const auto* _transitions = reinterpret_cast<const std::uint32_t*>(image + h->transitionsOffset);
+    for (std::uint64_t i = 0; i < ((std::uint64_t) h->numberOfStates + 1) * h->numberOfColumns; ++i) {
+        if (_transitions[i] > h->numberOfStates) {
+            throw InvalidFileException();
+        }
+    }
+    // the dead state is never acceptable, only an empty automaton may start in it
+    const auto* _accept = reinterpret_cast<const std::uint64_t*>(image + h->acceptOffset);
+    if ((_accept[h->numberOfStates >> 6] >> (h->numberOfStates & 63)) & 1) {
+        throw InvalidFileException();
+    }
+    this->header = h;
+    this->alphabet = _alphabet;
+    this->symbols = image + h->symbolsOffset;
+    this->transitions = _transitions;
+    this->accept = _accept;
+}
+
+const char* CompiledDFA::getImage() const {
+    return reinterpret_cast<const char*>(this->header);
+}
+
+std::size_t CompiledDFA::getImageSize() const {
+    return this->header->size;
+}
+
+unsigned int CompiledDFA::getNumberOfTransitions() const {
+    unsigned int result = 0;
+    for (std::uint32_t i = 0; i < this->getNumberOfStates(); ++i) {
+        for (std::uint32_t j = 0; j < this->getAlphabetSize(); ++j) {
+            if (this->nextByColumn(i, j) != this->getDeadState()) {
+                ++result;
+            }
+        }
+    }
+    return result;
+}
+
+bool CompiledDFA::regexMatch(const std::string& word) const {
+    std::uint32_t state = this->getStartState();
+    for (char c : word) {
+        state = this->next(state, c);
+    }
+    return this->isAcceptable(state);
+}
+
+RationalFunction<Rational<integer>> CompiledDFA::getGeneratingFunction() const {
+    STATISTICS_TIMER("getGeneratingFunction");
+    std::uint32_t n = this->getNumberOfStates();
+    if (n == 0) {
+        return RationalFunction<Rational<integer>>();
+    }
+    std::vector<std::vector<RationalFunction<Rational<integer>>>> a(n, std::vector<RationalFunction<Rational<integer>>>(n, RationalFunction<Rational<integer>>()));
+    for (std::uint32_t i = 0; i < n; ++i) {
+        a[i][i] = RationalFunction<Rational<integer>>(1);
+    }
+    for (std::uint32_t i = 0; i < n; ++i) {
+        for (std::uint32_t j = 0; j < this->getAlphabetSize(); ++j) {
+            std::uint32_t q = this->nextByColumn(i, j);
+            if (q != this->getDeadState()) {
+                a[i][q] -= RationalFunction<Rational<integer>>({(Rational<integer>) 0, (Rational<integer>) 1});
+            }
+        }
+    }
+    a = MatrixInversion<RationalFunction<Rational<integer>>>::gaussianElimination(a);
+    RationalFunction<Rational<integer>> result;
+    for (std::uint32_t i = 0; i < n; ++i) {
+        if (this->isAcceptable(i)) {
+            result += a[this->getStartState()][i];
+        }
+    }
+    return result;
+}
+
+DFA* CompiledDFA::toDFA() const {
+    std::uint32_t n = this->getNumberOfStates();
+    if (n == 0) {
+        return new DFA();
+    }
+    std::vector<DFA*> states(n);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        states[i] = new DFA();
+        states[i]->setAcceptable(this->isAcceptable(i));
+    }
+    for (std::uint32_t i = 0; i < n; ++i) {
+        for (std::uint32_t j = 0; j < this->getAlphabetSize(); ++j) {
+            std::uint32_t q = this->nextByColumn(i, j);
+            if (q != this->getDeadState()) {
+                (*states[i])[this->getSymbol(j)] = states[q];
+            }
+        }
+    }
+    return states[this->getStartState()];
+}
+
+void CompiledDFA::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    file.write(this->getImage(), this->getImageSize());
+    if (!file) {
+        throw InvalidFileException();
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef COMPILED_DFA_H
+#define COMPILED_DFA_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DFA.h"
+#include "MappedFile.h"
+
+// Flat, position independent image of a DFA. States are numbered canonically (see
+// DFA::getCanonicalStates), so equal languages give byte-identical images. The image is:
+//  - header,
+//  - alphabet map: 256 bytes mapping every symbol to its column,
+//  - symbols: the alphabet in increasing order, one byte per column,
+//  - transition table: uint32 per (state, column),
+//  - accept bitmap: uint64 words, bit i set if state i is acceptable.
+// Column numberOfColumns - 1 stands for all symbols outside the alphabet and state
+// numberOfStates is the dead state; both only lead to the dead state, so walking the table
+// never needs a branch. Sections are aligned to 64 bytes.
+//
+// A loaded file is the trust boundary: the header, the alphabet map and every transition are
+// validated once when the image is attached (InvalidFileException otherwise), so the accessors
+// below do no checks of their own.
+class CompiledDFA {
+public:
+    static const std::uint32_t VERSION = 1;
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t numberOfStates;
+        std::uint32_t numberOfColumns;
+        std::uint32_t startState;
+        std::uint32_t reserved;
+        std::uint64_t alphabetOffset;
+        std::uint64_t symbolsOffset;
+        std::uint64_t transitionsOffset;
+        std::uint64_t acceptOffset;
+        std::uint64_t size;
+    };
+private:
+    std::vector<std::uint64_t> buffer;
+    std::unique_ptr<MappedFile> file;
+    const Header* header = nullptr;
+    const std::uint8_t* alphabet = nullptr;
+    const char* symbols = nullptr;
+    const std::uint32_t* transitions = nullptr;
+    const std::uint64_t* accept = nullptr;
+    void attach(const char* image, std::size_t size);
+public:
+    explicit CompiledDFA(DFA* dfa);
+    explicit CompiledDFA(const std::string& path);
+    CompiledDFA(const CompiledDFA&) = delete;
+    CompiledDFA& operator = (const CompiledDFA&) = delete;
+    CompiledDFA(CompiledDFA&&) = default;
+    CompiledDFA& operator = (CompiledDFA&&) = default;
+
+    std::uint32_t getNumberOfStates() const {
+        return this->header->numberOfStates;
+    }
+
+    std::uint32_t getDeadState() const {
+        return this->header->numberOfStates;
+    }
+
+    std::uint32_t getStartState() const {
+        return this->header->startState;
+    }
+
+    // number of symbols in the alphabet, without the column for the remaining symbols
+    std::uint32_t getAlphabetSize() const {
+        return this->header->numberOfColumns - 1;
+    }
+
+    std::uint32_t getNumberOfColumns() const {
+        return this->header->numberOfColumns;
+    }
+
+    std::uint32_t getColumn(char symbol) const {
+        return this->alphabet[(unsigned char) symbol];
+    }
+
+    char getSymbol(std::uint32_t column) const {
+        return this->symbols[column];
+    }
+
+    const std::uint32_t* getTransitionTable() const {
+        return this->transitions;
+    }
+
+    std::uint32_t next(std::uint32_t state, char symbol) const {
+        return this->transitions[(std::size_t) state * this->header->numberOfColumns + this->alphabet[(unsigned char) symbol]];
+    }
+
+    std::uint32_t nextByColumn(std::uint32_t state, std::uint32_t column) const {
+        return this->transitions[(std::size_t) state * this->header->numberOfColumns + column];
+    }
+
+    bool isAcceptable(std::uint32_t state) const {
+        return (this->accept[state >> 6] >> (state & 63)) & 1;
+    }
+
+    const char* getImage() const;
+    std::size_t getImageSize() const;
+    unsigned int getNumberOfTransitions() const;
+    bool regexMatch(const std::string& word) const;
+    RationalFunction<Rational<integer>> getGeneratingFunction() const;
+    DFA* toDFA() const;
+    void save(const std::string& path) const;
+};
+
+#endif //COMPILED_DFA_H
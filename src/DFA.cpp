@@ -5,8 +5,12 @@
 #include <queue>
 #include <string>
 #include <list>
+#include <unordered_map>
+#include <algorithm>
 #include "DFA.h"
 #include "MatrixInversion.h"
+#include "Parallel.h"
+#include "Statistics.h"
 
 unsigned int DFA::getNumberOfStates() {
     std::queue<DFA*> remainingStates;
@@ -31,6 +35,30 @@ unsigned int DFA::getNumberOfStates() {
     return result;
 }
 
+unsigned int DFA::getNumberOfTransitions() {
+    std::queue<DFA*> remainingStates;
+    std::queue<DFA*> states;
+    remainingStates.push(this);
+    unsigned int result = 0;
+    while (!remainingStates.empty()) {
+        DFA* tree = remainingStates.front();
+        remainingStates.pop();
+        if (!tree->explored) {
+            tree->explored = true;
+            states.push(tree);
+            result += tree->transitions.size();
+            for (auto p : tree->transitions) {
+                remainingStates.push(p.second);
+            }
+        }
+    }
+    while (!states.empty()) {
+        states.front()->explored = false;
+        states.pop();
+    }
+    return result;
+}
+
 void DFA::setDepths() {
     std::queue<std::pair<DFA*, int>> remainingStates;
     remainingStates.emplace(this, 0);
@@ -65,6 +93,10 @@ void DFA::walk(std::string prefix, char transition, bool isLast, bool printChild
     }
 }
 
+int DFA::getIndex() const {
+    return this->index;
+}
+
 bool DFA::isExplored() const {
     return this->explored;
 }
@@ -98,7 +130,114 @@ bool DFA::regexMatch(const std::string& word) {
     return state->acceptable;
 }
 
+bool DFA::getPolynomialGeneratingFunction(std::vector<integer>& coefficients) {
+    std::vector<DFA*> states;
+    std::vector<std::vector<int>> predecessors;
+    std::stack<DFA*> stateStack;
+    stateStack.push(this);
+    while (!stateStack.empty()) {
+        DFA* state = stateStack.top();
+        stateStack.pop();
+        if (!state->explored) {
+            state->explored = true;
+            state->index = states.size();
+            states.push_back(state);
+            predecessors.emplace_back();
+            for (const auto& p : state->transitions) {
+                stateStack.push(p.second);
+            }
+        }
+    }
+    // one entry per transition, so that parallel transitions are counted separately
+    std::vector<int> numberOfSuccessors(states.size(), 0);
+    for (DFA* state : states) {
+        state->explored = false;
+        for (const auto& p : state->transitions) {
+            predecessors[p.second->index].push_back(state->index);
+        }
+    }
+
+    // states leading to an acceptable one, the others do not contribute to any coefficient
+    std::vector<bool> alive(states.size(), false);
+    std::stack<int> indexStack;
+    for (DFA* state : states) {
+        if (state->acceptable) {
+            alive[state->index] = true;
+            indexStack.push(state->index);
+        }
+    }
+    while (!indexStack.empty()) {
+        int i = indexStack.top();
+        indexStack.pop();
+        for (int j : predecessors[i]) {
+            ++numberOfSuccessors[j];
+            if (!alive[j]) {
+                alive[j] = true;
+                indexStack.push(j);
+            }
+        }
+    }
+
+    // Kahn's algorithm from the states without alive successors; a state left unprocessed lies
+    // on a cycle, and then the language is infinite
+    std::vector<std::vector<integer>> counts(states.size());
+    int numberOfAlive = 0;
+    for (int i = 0; i < states.size(); ++i) {
+        if (alive[i]) {
+            ++numberOfAlive;
+            if (numberOfSuccessors[i] == 0) {
+                indexStack.push(i);
+            }
+        }
+    }
+    int processed = 0;
+    while (!indexStack.empty()) {
+        int i = indexStack.top();
+        indexStack.pop();
+        ++processed;
+        // counts[i][k] is the number of words of length k leading from state i to acceptance
+        std::vector<integer>& c = counts[i];
+        if (c.empty()) {
+            c.emplace_back(0);
+        }
+        if (states[i]->acceptable) {
+            ++c[0];
+        }
+        for (int j : predecessors[i]) {
+            std::vector<integer>& d = counts[j];
+            if (d.size() < c.size() + 1) {
+                d.resize(c.size() + 1, 0);
+            }
+            for (std::size_t k = 0; k < c.size(); ++k) {
+                d[k + 1] += c[k];
+            }
+            if (--numberOfSuccessors[j] == 0) {
+                indexStack.push(j);
+            }
+        }
+        if (i != 0) {
+            std::vector<integer>().swap(c);
+        }
+    }
+    if (processed < numberOfAlive) {
+        return false;
+    }
+    coefficients = counts[0];
+    return true;
+}
+
 RationalFunction<Rational<integer>> DFA::getGeneratingFunction() {
+    STATISTICS_TIMER("getGeneratingFunction");
+    // a finite language has a polynomial generating function, computed without the matrix
+    std::vector<integer> coefficients;
+    if (this->getPolynomialGeneratingFunction(coefficients)) {
+        STATISTICS_ADD("getGeneratingFunction.polynomial", 1);
+        std::vector<Rational<integer>> result;
+        for (const integer& c : coefficients) {
+            result.emplace_back(c);
+        }
+        return RationalFunction<Rational<integer>>(result);
+    }
     int counter = 0;
     std::stack<DFA*> states;
     std::stack<DFA*> stateStack;
@@ -139,11 +278,159 @@ RationalFunction<Rational<integer>> DFA::getGeneratingFunction() {
     return result;
 }
 
+DFA* DFA::complement(const std::string& alphabet) {
+    STATISTICS_TIMER("complement");
+    // missing transitions lead to the dead state, which becomes an accepting sink
+    std::unordered_map<DFA*, DFA*> copies;
+    std::queue<DFA*> remainingStates;
+    DFA* sink = nullptr;
+    auto getCopy = [&](DFA* state) {
+        DFA*& copy = copies[state];
+        if (copy == nullptr) {
+            copy = new DFA();
+            copy->acceptable = !state->acceptable;
+            remainingStates.push(state);
+        }
+        return copy;
+    };
+    DFA* result = getCopy(this);
+    while (!remainingStates.empty()) {
+        DFA* state = remainingStates.front();
+        remainingStates.pop();
+        DFA* copy = copies[state];
+        for (char c : alphabet) {
+            auto it = state->transitions.find(c);
+            if (it != state->transitions.end()) {
+                copy->transitions[c] = getCopy(it->second);
+            } else {
+                if (sink == nullptr) {
+                    sink = new DFA();
+                    sink->acceptable = true;
+                    for (char d : alphabet) {
+                        sink->transitions[d] = sink;
+                    }
+                }
+                copy->transitions[c] = sink;
+            }
+        }
+    }
+    return result;
+}
+
+const std::map<char, DFA*>& DFA::getTransitions() const {
+    return this->transitions;
+}
+
 DFA*& DFA::operator [] (char transition) {
     return this->transitions[transition];
 }
 
+void DFA::removeTransition(char transition) {
+    this->transitions.erase(transition);
+}
+
+std::string DFA::getSignature() const {
+    std::string signature(1, this->acceptable ? '1' : '0');
+    for (const auto& p : this->transitions) {
+        signature.push_back(p.first);
+        signature.append(reinterpret_cast<const char*>(&p.second), sizeof(DFA*));
+    }
+    return signature;
+}
+
+std::vector<DFA*> DFA::getCanonicalStates() {
+    // find the set of all states together with reversed transitions
+    std::vector<DFA*> states;
+    std::map<DFA*, std::vector<DFA*>> predecessors;
+    std::queue<DFA*> remainingStates;
+    remainingStates.push(this);
+    while (!remainingStates.empty()) {
+        DFA* state = remainingStates.front();
+        remainingStates.pop();
+        if (!state->explored) {
+            state->explored = true;
+            states.push_back(state);
+            for (const auto& p : state->transitions) {
+                predecessors[p.second].push_back(state);
+                remainingStates.push(p.second);
+            }
+        }
+    }
+
+    // mark states from which an acceptable state is reachable
+    std::stack<DFA*> stateStack;
+    for (DFA* state : states) {
+        state->explored = false;
+        if (state->acceptable) {
+            stateStack.push(state);
+        }
+    }
+    std::set<DFA*> alive;
+    while (!stateStack.empty()) {
+        DFA* state = stateStack.top();
+        stateStack.pop();
+        if (alive.insert(state).second) {
+            for (DFA* q : predecessors[state]) {
+                stateStack.push(q);
+            }
+        }
+    }
+
+    // BFS over alive states with transitions visited in alphabetical order
+    std::vector<DFA*> result;
+    if (alive.count(this) == 0) {
+        return result;
+    }
+    this->explored = true;
+    this->index = 0;
+    result.push_back(this);
+    for (int i = 0; i < result.size(); ++i) {
+        for (const auto& p : result[i]->transitions) {
+            DFA* q = p.second;
+            if (!q->explored && alive.count(q) > 0) {
+                q->explored = true;
+                q->index = result.size();
+                result.push_back(q);
+            }
+        }
+    }
+    for (DFA* state : result) {
+        state->explored = false;
+    }
+    return result;
+}
+
+std::string DFA::getCanonicalEncoding() {
+    std::vector<DFA*> states = this->getCanonicalStates();
+    std::string encoding;
+    auto appendNumber = [&encoding](unsigned int n) {
+        for (int i = 0; i < 4; ++i) {
+            encoding.push_back((char) ((n >> (8 * i)) & 0xFF));
+        }
+    };
+    appendNumber(states.size());
+    for (DFA* state : states) {
+        unsigned int numberOfTransitions = 0;
+        for (const auto& p : state->transitions) {
+            // transitions to states outside the canonical set lead to the dead state
+            if (p.second->index < states.size() && states[p.second->index] == p.second) {
+                ++numberOfTransitions;
+            }
+        }
+        encoding.push_back(state->acceptable ? '\1' : '\0');
+        appendNumber(numberOfTransitions);
+        for (const auto& p : state->transitions) {
+            if (p.second->index < states.size() && states[p.second->index] == p.second) {
+                encoding.push_back(p.first);
+                appendNumber(p.second->index);
+            }
+        }
+    }
+    return encoding;
+}
+
 DFA* DFA::minimize() {
+    STATISTICS_TIMER("minimize");
     std::stack<DFA*> stateStack;
     std::vector<DFA*> states;
     states.push_back(new DFA());
@@ -304,7 +591,152 @@ DFA* DFA::minimize() {
     delete[] candidatesToMark;
     delete[] connectedStates;
     if (hasWords) {
+        STATISTICS_SET("minimal_dfa.states", this->getNumberOfStates());
+        STATISTICS_SET("minimal_dfa.transitions", this->getNumberOfTransitions());
         return this;
     }
+    STATISTICS_SET("minimal_dfa.states", 1);
+    STATISTICS_SET("minimal_dfa.transitions", 0);
     return states[0];
+}
+
+DFA* DFA::minimize(unsigned int numberOfThreads) {
+    STATISTICS_TIMER("minimize");
+    // dense copy of the transition function, state n is the dead state
+    std::vector<DFA*> states;
+    std::queue<DFA*> remainingStates;
+    remainingStates.push(this);
+    while (!remainingStates.empty()) {
+        DFA* state = remainingStates.front();
+        remainingStates.pop();
+        if (!state->explored) {
+            state->explored = true;
+            state->index = states.size();
+            states.push_back(state);
+            for (const auto& p : state->transitions) {
+                remainingStates.push(p.second);
+            }
+        }
+    }
+    std::string alphabet;
+    for (DFA* state : states) {
+        state->explored = false;
+        for (const auto& p : state->transitions) {
+            alphabet.push_back(p.first);
+        }
+    }
+    std::sort(alphabet.begin(), alphabet.end());
+    alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+    unsigned int n = states.size();
+    unsigned int k = alphabet.size();
+    std::vector<unsigned int> next((std::size_t) (n + 1) * k, n);
+    std::vector<unsigned int> block(n + 1, 0);
+    for (unsigned int i = 0; i < n; ++i) {
+        for (const auto& p : states[i]->transitions) {
+            next[(std::size_t) i * k + (std::lower_bound(alphabet.begin(), alphabet.end(), p.first) - alphabet.begin())] = p.second->index;
+        }
+        block[i] = states[i]->acceptable ? 1 : 0;
+    }
+
+    // Moore refinement: in every round states are grouped by the signature made of their own
+    // block and the blocks of their successors, until the number of blocks stops growing
+    std::vector<unsigned int> newBlock(n + 1);
+    std::vector<std::size_t> signatureHash(n + 1);
+    unsigned int numberOfBlocks = 0;
+    unsigned int newNumberOfBlocks = 1;
+    for (unsigned int i = 0; i < n; ++i) {
+        if (block[i] == 1) {
+            newNumberOfBlocks = 2;
+        }
+    }
+    auto sameSignature = [&](unsigned int s, unsigned int t) {
+        if (block[s] != block[t]) {
+            return false;
+        }
+        for (unsigned int a = 0; a < k; ++a) {
+            if (block[next[(std::size_t) s * k + a]] != block[next[(std::size_t) t * k + a]]) {
+                return false;
+            }
+        }
+        return true;
+    };
+    while (newNumberOfBlocks != numberOfBlocks) {
+        STATISTICS_ADD("minimize.rounds", 1);
+        numberOfBlocks = newNumberOfBlocks;
+        std::vector<std::vector<std::vector<unsigned int>>> buckets(numberOfThreads, std::vector<std::vector<unsigned int>>(numberOfThreads));
+        Parallel::run(numberOfThreads, [&](unsigned int t) {
+            for (unsigned int s = t; s <= n; s += numberOfThreads) {
+                std::size_t h = block[s];
+                for (unsigned int a = 0; a < k; ++a) {
+                    h ^= block[next[(std::size_t) s * k + a]] + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+                }
+                signatureHash[s] = h;
+                buckets[t][h % numberOfThreads].push_back(s);
+            }
+        });
+        // every thread numbers the signatures of its own shard, then the numbers are offset
+        std::vector<unsigned int> numberOfShardBlocks(numberOfThreads);
+        Parallel::run(numberOfThreads, [&](unsigned int t) {
+            auto hash = [&signatureHash](unsigned int s) {
+                return signatureHash[s];
+            };
+            std::unordered_map<unsigned int, unsigned int, decltype(hash), decltype(sameSignature)> shardBlocks(16, hash, sameSignature);
+            for (unsigned int u = 0; u < numberOfThreads; ++u) {
+                for (unsigned int s : buckets[u][t]) {
+                    newBlock[s] = shardBlocks.emplace(s, shardBlocks.size()).first->second;
+                }
+            }
+            numberOfShardBlocks[t] = shardBlocks.size();
+        });
+        std::vector<unsigned int> offset(numberOfThreads, 0);
+        for (unsigned int t = 1; t < numberOfThreads; ++t) {
+            offset[t] = offset[t - 1] + numberOfShardBlocks[t - 1];
+        }
+        newNumberOfBlocks = offset[numberOfThreads - 1] + numberOfShardBlocks[numberOfThreads - 1];
+        Parallel::run(numberOfThreads, [&](unsigned int t) {
+            for (unsigned int s = t; s <= n; s += numberOfThreads) {
+                newBlock[s] += offset[signatureHash[s] % numberOfThreads];
+            }
+        });
+        std::swap(block, newBlock);
+    }
+
+    // the first state of every block in BFS order represents it, so this state is kept,
+    // transitions to the block of the dead state are removed
+    std::vector<int> representative(numberOfBlocks, -1);
+    for (unsigned int i = 0; i < n; ++i) {
+        if (representative[block[i]] == -1) {
+            representative[block[i]] = i;
+        }
+    }
+    unsigned int deadBlock = block[n];
+    if (block[0] == deadBlock) {
+        for (DFA* state : states) {
+            delete state;
+        }
+        STATISTICS_SET("minimal_dfa.states", 1);
+        STATISTICS_SET("minimal_dfa.transitions", 0);
+        return new DFA();
+    }
+    for (unsigned int i = 0; i < n; ++i) {
+        if (representative[block[i]] == i) {
+            auto it = states[i]->transitions.begin();
+            while (it != states[i]->transitions.end()) {
+                if (block[it->second->index] == deadBlock) {
+                    it = states[i]->transitions.erase(it);
+                } else {
+                    it->second = states[representative[block[it->second->index]]];
+                    ++it;
+                }
+            }
+        }
+    }
+    for (unsigned int i = 0; i < n; ++i) {
+        if (representative[block[i]] != i) {
+            delete states[i];
+        }
+    }
+    STATISTICS_SET("minimal_dfa.states", this->getNumberOfStates());
+    STATISTICS_SET("minimal_dfa.transitions", this->getNumberOfTransitions());
+    return this;
 }
\ No newline at end of file
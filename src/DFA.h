@@ -3,6 +3,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include "RationalFunction.h"
 #include "Rational.h"
 #include <gmpxx.h>
@@ -17,17 +18,32 @@ private:
     int index = 0;
     void setDepths();
     void walk(std::string prefix = "", char transition = '\0', bool isLast = true, bool printChildren = true);
+    // coefficients of the generating function if no cycle passes through states leading to an
+    // acceptable one, otherwise false
+    bool getPolynomialGeneratingFunction(std::vector<integer>& coefficients);
 public:
+    int getIndex() const;
     bool isExplored() const;
     void setExplored(bool explored);
     bool isAcceptable() const;
     void setAcceptable(bool acceptable);
     unsigned int getNumberOfStates();
+    unsigned int getNumberOfTransitions();
     void print();
     bool regexMatch(const std::string& word);
+    const std::map<char, DFA*>& getTransitions() const;
     DFA*& operator [] (char transition);
+    void removeTransition(char transition);
+    // the acceptance and the transitions; once the successors are unique, states are equivalent
+    // iff their signatures are equal
+    std::string getSignature() const;
+    std::vector<DFA*> getCanonicalStates();
+    std::string getCanonicalEncoding();
     RationalFunction<Rational<integer>> getGeneratingFunction();
+    // a new automaton accepting the words over the alphabet rejected by this one
+    DFA* complement(const std::string& alphabet);
     DFA* minimize();
+    DFA* minimize(unsigned int numberOfThreads);
 };
 
 #endif //DFA_H
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include "DictionaryAutomaton.h"
+#include "MappedFile.h"
+#include "UnsortedWordListException.h"
+#include "Statistics.h"
+
+template <typename F>
+static void forEachWord(const MappedFile& file, F f) {
+    const char* position = file.getData();
+    const char* end = position + file.getSize();
+    while (position < end) {
+        const char* newline = static_cast<const char*>(std::memchr(position, '\n', end - position));
+        const char* lineEnd = newline != nullptr ? newline : end;
+        const char* wordEnd = lineEnd;
+        if (wordEnd > position && wordEnd[-1] == '\r') {
+            --wordEnd;
+        }
+        if (wordEnd > position) {
+            f(position, wordEnd - position);
+        }
+        position = lineEnd + 1;
+    }
+}
+
+DFA* DictionaryAutomaton::fromSortedWords(const std::string& path) {
+    STATISTICS_TIMER("fromSortedWords");
+    MappedFile file(path);
+    DFA* root = new DFA();
+    std::unordered_map<std::string, DFA*> registered;
+    // states[i] is the state reached by the first i letters of the previous word
+    std::vector<DFA*> states = {root};
+    std::string previous;
+    unsigned long long numberOfWords = 0;
+    auto replaceOrRegister = [&](std::size_t length) {
+        for (std::size_t i = previous.size(); i > length; --i) {
+            DFA* state = states[i];
+            auto inserted = registered.emplace(state->getSignature(), state);
+            if (!inserted.second) {
+                (*states[i - 1])[previous[i - 1]] = inserted.first->second;
+                delete state;
+            }
+        }
+        states.resize(length + 1);
+    };
+    forEachWord(file, [&](const char* word, std::size_t length) {
+        int comparison = previous.compare(0, std::string::npos, word, length);
+        if (comparison == 0 && numberOfWords > 0) {
+            return;
+        }
+        if (comparison > 0) {
+            throw UnsortedWordListException();
+        }
+        std::size_t common = 0;
+        while (common < previous.size() && common < length && previous[common] == word[common]) {
+            ++common;
+        }
+        replaceOrRegister(common);
+        for (std::size_t i = common; i < length; ++i) {
+            DFA* state = new DFA();
+            (*states.back())[word[i]] = state;
+            states.push_back(state);
+        }
+        states.back()->setAcceptable(true);
+        previous.assign(word, length);
+        ++numberOfWords;
+    });
+    replaceOrRegister(0);
+    STATISTICS_SET("dictionary.words", numberOfWords);
+    STATISTICS_SET("dictionary.states", registered.size() + 1);
+    return root;
+}
+
+DFA* DictionaryAutomaton::containingAny(const std::string& path, std::string alphabet) {
+    STATISTICS_TIMER("containingAny");
+    // every letter once, a repeated one would be completed again from its own transition
+    std::sort(alphabet.begin(), alphabet.end());
+    alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+    // the trie of the words, its states are the states of the automaton
+    MappedFile file(path);
+    DFA* root = new DFA();
+    std::vector<DFA*> nodes = {root};
+    bool letters[256] = {};
+    bool inAlphabet[256] = {};
+    for (char c : alphabet) {
+        inAlphabet[(unsigned char) c] = true;
+    }
+    forEachWord(file, [&](const char* word, std::size_t length) {
+        // a word with a letter outside the alphabet never occurs
+        if (!alphabet.empty()) {
+            for (std::size_t i = 0; i < length; ++i) {
+                if (!inAlphabet[(unsigned char) word[i]]) {
+                    return;
+                }
+            }
+        }
+        DFA* state = root;
+        for (std::size_t i = 0; i < length; ++i) {
+            auto it = state->getTransitions().find(word[i]);
+            if (it == state->getTransitions().end()) {
+                DFA* next = new DFA();
+                (*state)[word[i]] = next;
+                nodes.push_back(next);
+                state = next;
+            } else {
+                state = it->second;
+            }
+            letters[(unsigned char) word[i]] = true;
+        }
+        state->setAcceptable(true);
+    });
+    if (alphabet.empty()) {
+        for (int c = 1; c < 256; ++c) {
+            if (letters[c]) {
+                alphabet.push_back((char) c);
+            }
+        }
+    }
+
+    // breadth-first search setting the failure links, a missing transition of a state is the
+    // transition of its failure state, which is shallower and hence already complete; a state
+    // is matching if its failure state is, and the search does not go below matching states
+    std::unordered_map<DFA*, DFA*> failure;
+    std::vector<DFA*> kept;
+    std::queue<DFA*> queue;
+    failure[root] = root;
+    queue.push(root);
+    while (!queue.empty()) {
+        DFA* state = queue.front();
+        queue.pop();
+        if (state->isAcceptable()) {
+            continue;
+        }
+        kept.push_back(state);
+        DFA* fallback = failure[state];
+        for (char c : alphabet) {
+            auto it = state->getTransitions().find(c);
+            DFA* next = state == root ? root : fallback->getTransitions().at(c);
+            if (it != state->getTransitions().end()) {
+                failure[it->second] = next;
+                if (next->isAcceptable()) {
+                    it->second->setAcceptable(true);
+                }
+                queue.push(it->second);
+            } else {
+                (*state)[c] = next;
+            }
+        }
+    }
+
+    // all matching states are merged into one
+    DFA* found = new DFA();
+    found->setAcceptable(true);
+    for (char c : alphabet) {
+        (*found)[c] = found;
+    }
+    for (DFA* state : kept) {
+        for (char c : alphabet) {
+            DFA*& next = (*state)[c];
+            if (next->isAcceptable()) {
+                next = found;
+            }
+        }
+    }
+    for (DFA* node : nodes) {
+        if (node->isAcceptable() || failure.find(node) == failure.end()) {
+            delete node;
+        }
+    }
+    STATISTICS_SET("dictionary.states", kept.size() + 1);
+    return root;
+}
+
+DFA* DictionaryAutomaton::avoidingAll(const std::string& path, const std::string& alphabet, unsigned int numberOfThreads) {
+    DFA* containing = containingAny(path, alphabet);
+    // the automaton is complete, so its alphabet can be read from any state
+    std::string letters;
+    for (const auto& p : containing->getTransitions()) {
+        letters.push_back(p.first);
+    }
+    return containing->complement(letters)->minimize(numberOfThreads);
+}
@@ -0,0 +1,25 @@
+#ifndef DICTIONARY_AUTOMATON_H
+#define DICTIONARY_AUTOMATON_H
+
+#include <string>
+#include "DFA.h"
+
+// Automata built directly from word lists with one word per line, read through a memory
+// mapping, so that dictionaries far too large for a union in a regular expression can be used.
+// Empty lines are skipped.
+class DictionaryAutomaton {
+public:
+    // minimal acyclic DFA accepting exactly the words, built incrementally (Daciuk et al.): the
+    // list has to be sorted bytewise (as by LC_ALL=C sort), so the states of the previous word beyond the common prefix with
+    // the next one are final and can be merged with equivalent registered states at once; the
+    // memory used is bounded by the size of the result, not of the list
+    static DFA* fromSortedWords(const std::string& path);
+    // complete DFA over the alphabet accepting the words containing some word of the list, the
+    // Aho-Corasick automaton of the list with all matching states merged into one absorbing
+    // state; the default alphabet consists of the letters of the words
+    static DFA* containingAny(const std::string& path, std::string alphabet = "");
+    // minimal DFA accepting the words over the alphabet containing none of the words of the list
+    static DFA* avoidingAll(const std::string& path, const std::string& alphabet = "", unsigned int numberOfThreads = 1);
+};
+
+#endif //DICTIONARY_AUTOMATON_H
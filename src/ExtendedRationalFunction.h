@@ -6,6 +6,7 @@
 #include "Polynomial.h"
 #include "RationalFunction.h"
 #include "Rational.h"
+#include "Statistics.h"
 
 template <typename T>
 class ExtendedRationalFunction {
@@ -15,12 +16,31 @@ private:
     std::list<std::pair<Polynomial<Rational<T>>, unsigned int>> denominator;
 public:
     explicit ExtendedRationalFunction(RationalFunction<Rational<T>> f) {
+        STATISTICS_TIMER("decompose");
         auto p = f.getNumerator().div(f.getDenominator());
         this->rest = p.first;
         this->numerator = p.second;
         this->denominator = this->decompose(f.getDenominator());
     }
 
+    ExtendedRationalFunction(Polynomial<Rational<T>> _rest, Polynomial<Rational<T>> _numerator, std::list<std::pair<Polynomial<Rational<T>>, unsigned int>> _denominator) {
+        this->rest = _rest;
+        this->numerator = _numerator;
+        this->denominator = _denominator;
+    }
+
+    Polynomial<Rational<T>> getRest() const {
+        return this->rest;
+    }
+
+    Polynomial<Rational<T>> getNumerator() const {
+        return this->numerator;
+    }
+
+    std::list<std::pair<Polynomial<Rational<T>>, unsigned int>> getDenominator() const {
+        return this->denominator;
+    }
+
     std::list<std::pair<Polynomial<Rational<T>>, unsigned int>> decompose(Polynomial<Rational<T>> a) {
         T _gcd = a[0].getDenominator();
         for (int i = 1; i <= a.degree(); ++i) {
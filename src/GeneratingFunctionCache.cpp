@@ -0,0 +1,154 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "GeneratingFunctionCache.h"
+
+static const char* const CACHE_FILE_HEADER = "CFLGF 1";
+
+static void writePolynomial(std::ostream& s, const Polynomial<Rational<integer>>& a) {
+    std::vector<Rational<integer>> coefficients = a.getCoefficients();
+    s << coefficients.size();
+    for (const auto& c : coefficients) {
+        s << " " << c.getNumerator() << " " << c.getDenominator();
+    }
+    s << "\n";
+}
+
+static bool readPolynomial(std::istream& s, Polynomial<Rational<integer>>& a) {
+    unsigned int n;
+    if (!(s >> n)) {
+        return false;
+    }
+    std::vector<Rational<integer>> coefficients;
+    for (unsigned int i = 0; i < n; ++i) {
+        integer numerator, denominator;
+        if (!(s >> numerator >> denominator) || denominator == 0) {
+            return false;
+        }
+        coefficients.emplace_back(numerator, denominator, false);
+    }
+    a = Polynomial<Rational<integer>>(coefficients);
+    return true;
+}
+
+static std::string toHex(const std::string& bytes) {
+    static const char* const digits = "0123456789abcdef";
+    std::string result;
+    for (char c : bytes) {
+        result.push_back(digits[((unsigned char) c) >> 4]);
+        result.push_back(digits[((unsigned char) c) & 0xF]);
+    }
+    return result;
+}
+
+GeneratingFunctionCache::GeneratingFunctionCache(std::string directory) {
+    this->directory = directory;
+}
+
+unsigned long long GeneratingFunctionCache::hash(const std::string& encoding) {
+    // 64-bit FNV-1a
+    unsigned long long h = 14695981039346656037ULL;
+    for (char c : encoding) {
+        h ^= (unsigned char) c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+unsigned int GeneratingFunctionCache::getHits() const {
+    return this->hits;
+}
+
+unsigned int GeneratingFunctionCache::getMisses() const {
+    return this->misses;
+}
+
+std::string GeneratingFunctionCache::getPath(const std::string& encoding) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.gf", GeneratingFunctionCache::hash(encoding));
+    return this->directory + "/" + name;
+}
+
+bool GeneratingFunctionCache::load(const std::string& encoding) {
+    if (this->directory.empty()) {
+        return false;
+    }
+    std::ifstream file(this->getPath(encoding));
+    std::string header, storedEncoding;
+    if (!std::getline(file, header) || header != CACHE_FILE_HEADER || !(file >> storedEncoding)) {
+        return false;
+    }
+    // different languages may share a hash, so the stored encoding has to match exactly
+    if (storedEncoding != toHex(encoding)) {
+        return false;
+    }
+    Polynomial<Rational<integer>> numerator, denominator, rest, extendedNumerator;
+    unsigned int numberOfFactors;
+    if (!readPolynomial(file, numerator) || !readPolynomial(file, denominator) || denominator == Polynomial<Rational<integer>>()
+        || !readPolynomial(file, rest) || !readPolynomial(file, extendedNumerator) || !(file >> numberOfFactors)) {
+        return false;
+    }
+    std::list<std::pair<Polynomial<Rational<integer>>, unsigned int>> factors;
+    for (unsigned int i = 0; i < numberOfFactors; ++i) {
+        std::pair<Polynomial<Rational<integer>>, unsigned int> p;
+        if (!(file >> p.second) || !readPolynomial(file, p.first)) {
+            return false;
+        }
+        factors.push_back(p);
+    }
+    this->entries.emplace(encoding, std::make_pair(Function(numerator, denominator, false), ExtendedFunction(rest, extendedNumerator, factors)));
+    return true;
+}
+
+void GeneratingFunctionCache::store(const std::string& encoding) const {
+    if (this->directory.empty()) {
+        return;
+    }
+    const auto& entry = this->entries.at(encoding);
+    std::string path = this->getPath(encoding);
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath);
+        if (!file) {
+            return;
+        }
+        file << CACHE_FILE_HEADER << "\n" << toHex(encoding) << "\n";
+        writePolynomial(file, entry.first.getNumerator());
+        writePolynomial(file, entry.first.getDenominator());
+        writePolynomial(file, entry.second.getRest());
+        writePolynomial(file, entry.second.getNumerator());
+        auto factors = entry.second.getDenominator();
+        file << factors.size() << "\n";
+        for (const auto& p : factors) {
+            file << p.second << " ";
+            writePolynomial(file, p.first);
+        }
+        if (!file) {
+            std::remove(temporaryPath.c_str());
+            return;
+        }
+    }
+    // rename is atomic, so concurrent readers never see a partially written entry
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+    }
+}
+
+bool GeneratingFunctionCache::contains(DFA* dfa) {
+    std::string encoding = dfa->getCanonicalEncoding();
+    return this->entries.count(encoding) > 0 || this->load(encoding);
+}
+
+std::pair<GeneratingFunctionCache::Function, GeneratingFunctionCache::ExtendedFunction> GeneratingFunctionCache::get(DFA* dfa) {
+    std::string encoding = dfa->getCanonicalEncoding();
+    auto it = this->entries.find(encoding);
+    if (it != this->entries.end() || (this->load(encoding) && (it = this->entries.find(encoding)) != this->entries.end())) {
+        ++this->hits;
+        return it->second;
+    }
+    ++this->misses;
+    Function f = dfa->getGeneratingFunction();
+    it = this->entries.emplace(encoding, std::make_pair(f, ExtendedFunction(f))).first;
+    this->store(encoding);
+    return it->second;
+}
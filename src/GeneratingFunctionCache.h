@@ -0,0 +1,36 @@
+#ifndef GENERATING_FUNCTION_CACHE_H
+#define GENERATING_FUNCTION_CACHE_H
+
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include "DFA.h"
+#include "RationalFunction.h"
+#include "ExtendedRationalFunction.h"
+
+// Cache of generating functions keyed by the canonical encoding of a minimized DFA, so that
+// syntactically different regular expressions denoting the same language are computed once.
+// Entries are kept in memory and, if a directory is given, also stored in files named after
+// the hash of the encoding.
+class GeneratingFunctionCache {
+public:
+    typedef RationalFunction<Rational<integer>> Function;
+    typedef ExtendedRationalFunction<integer> ExtendedFunction;
+private:
+    std::unordered_map<std::string, std::pair<Function, ExtendedFunction>> entries;
+    std::string directory;
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+    std::string getPath(const std::string& encoding) const;
+    bool load(const std::string& encoding);
+    void store(const std::string& encoding) const;
+public:
+    explicit GeneratingFunctionCache(std::string directory = "");
+    static unsigned long long hash(const std::string& encoding);
+    unsigned int getHits() const;
+    unsigned int getMisses() const;
+    bool contains(DFA* dfa);
+    std::pair<Function, ExtendedFunction> get(DFA* dfa);
+};
+
+#endif //GENERATING_FUNCTION_CACHE_H
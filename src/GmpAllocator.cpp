@@ -0,0 +1,237 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <algorithm>
+#include <gmp.h>
+#include "GmpAllocator.h"
+
+struct BlockHeader {
+    GmpAllocator::Arena::Chunk* chunk;
+    std::size_t capacity;
+};
+
+// live counts the blocks in use plus one reference held by the arena while it is alive, so
+// whoever brings it to zero is the only one left and frees the chunk; nobody touches a chunk
+// after their own decrement. owner is cleared before the arena drops its reference.
+struct GmpAllocator::Arena::Chunk {
+    Chunk* next;
+    std::atomic<Arena*> owner;
+    std::atomic<std::size_t> live;
+};
+
+static const std::size_t CHUNK_HEADER_SIZE = (sizeof(GmpAllocator::Arena::Chunk) + 15) & ~(std::size_t) 15;
+
+static std::atomic<unsigned long long> allocations(0);
+static std::atomic<unsigned long long> reallocations(0);
+static std::atomic<unsigned long long> frees(0);
+static std::atomic<unsigned long long> allocatedBytes(0);
+static std::atomic<long long> currentBytes(0);
+static std::atomic<long long> peakBytes(0);
+static thread_local unsigned long long threadAllocations = 0;
+static thread_local unsigned long long threadAllocatedBytes = 0;
+static thread_local GmpAllocator::Arena* currentArena = nullptr;
+
+bool GmpAllocator::installed = false;
+
+static void* allocateOrAbort(std::size_t size) {
+    void* result = std::malloc(size);
+    if (result == nullptr) {
+        std::fprintf(stderr, "GMP: cannot allocate %zu bytes\n", size);
+        std::abort();
+    }
+    return result;
+}
+
+static void count(long long difference) {
+    long long current = currentBytes.fetch_add(difference, std::memory_order_relaxed) + difference;
+    long long peak = peakBytes.load(std::memory_order_relaxed);
+    while (current > peak && !peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+    if (difference > 0) {
+        allocatedBytes.fetch_add(difference, std::memory_order_relaxed);
+        threadAllocatedBytes += difference;
+    }
+}
+
+static void release(GmpAllocator::Arena::Chunk* chunk) {
+    if (chunk->live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::free(chunk);
+    }
+}
+
+GmpAllocator::Arena::Arena(std::size_t _chunkSize) {
+    this->chunkSize = _chunkSize;
+    this->previous = currentArena;
+    currentArena = this;
+}
+
+GmpAllocator::Arena::~Arena() {
+    currentArena = this->previous;
+    Chunk* chunk = this->chunks;
+    while (chunk != nullptr) {
+        Chunk* next = chunk->next;
+        chunk->owner.store(nullptr, std::memory_order_relaxed);
+        release(chunk);
+        chunk = next;
+    }
+}
+
+void* GmpAllocator::Arena::allocate(std::size_t size) {
+    int sizeClass = 0;
+    while (((std::size_t) 16 << sizeClass) < size) {
+        ++sizeClass;
+    }
+    if (sizeClass >= NUMBER_OF_SIZE_CLASSES) {
+        return nullptr;
+    }
+    std::size_t capacity = (std::size_t) 16 << sizeClass;
+    BlockHeader* header;
+    if (this->freeBlocks[sizeClass] != nullptr) {
+        // the link to the next free block is kept in the first bytes of a free block
+        void* block = this->freeBlocks[sizeClass];
+        std::memcpy(&this->freeBlocks[sizeClass], block, sizeof(void*));
+        header = static_cast<BlockHeader*>(block) - 1;
+    } else {
+        std::size_t need = sizeof(BlockHeader) + capacity;
+        if (this->position == nullptr || this->position + need > this->end) {
+            std::size_t size = std::max(this->chunkSize, need);
+            auto* chunk = static_cast<Chunk*>(allocateOrAbort(CHUNK_HEADER_SIZE + size));
+            chunk->next = this->chunks;
+            new (&chunk->owner) std::atomic<Arena*>(this);
+            new (&chunk->live) std::atomic<std::size_t>(1);
+            this->chunks = chunk;
+            this->position = reinterpret_cast<char*>(chunk) + CHUNK_HEADER_SIZE;
+            this->end = this->position + size;
+        }
+        header = reinterpret_cast<BlockHeader*>(this->position);
+        header->chunk = this->chunks;
+        header->capacity = capacity;
+        this->position += need;
+    }
+    header->chunk->live.fetch_add(1, std::memory_order_relaxed);
+    return header + 1;
+}
+
+void GmpAllocator::Arena::free(void* block) {
+    BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+    int sizeClass = 0;
+    while (((std::size_t) 16 << sizeClass) < header->capacity) {
+        ++sizeClass;
+    }
+    std::memcpy(block, &this->freeBlocks[sizeClass], sizeof(void*));
+    this->freeBlocks[sizeClass] = block;
+    // the arena still holds its own reference, so this never reaches zero
+    header->chunk->live.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void* GmpAllocator::allocate(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    ++threadAllocations;
+    count(size);
+    if (currentArena != nullptr) {
+        void* block = currentArena->allocate(size);
+        if (block != nullptr) {
+            return block;
+        }
+    }
+    auto* header = static_cast<BlockHeader*>(allocateOrAbort(sizeof(BlockHeader) + size));
+    header->chunk = nullptr;
+    header->capacity = size;
+    return header + 1;
+}
+
+void* GmpAllocator::reallocate(void* pointer, std::size_t oldSize, std::size_t newSize) {
+    reallocations.fetch_add(1, std::memory_order_relaxed);
+    count((long long) newSize - (long long) oldSize);
+    BlockHeader* header = static_cast<BlockHeader*>(pointer) - 1;
+    if (header->chunk == nullptr) {
+        header = static_cast<BlockHeader*>(std::realloc(header, sizeof(BlockHeader) + newSize));
+        if (header == nullptr) {
+            std::fprintf(stderr, "GMP: cannot allocate %zu bytes\n", newSize);
+            std::abort();
+        }
+        header->capacity = newSize;
+        return header + 1;
+    }
+    if (newSize <= header->capacity) {
+        return pointer;
+    }
+    // the accounting for the new block was done above
+    void* result = nullptr;
+    if (currentArena != nullptr) {
+        result = currentArena->allocate(newSize);
+    }
+    if (result == nullptr) {
+        auto* newHeader = static_cast<BlockHeader*>(allocateOrAbort(sizeof(BlockHeader) + newSize));
+        newHeader->chunk = nullptr;
+        newHeader->capacity = newSize;
+        result = newHeader + 1;
+    }
+    std::memcpy(result, pointer, std::min(oldSize, newSize));
+    Arena::Chunk* chunk = header->chunk;
+    if (currentArena != nullptr && chunk->owner.load(std::memory_order_relaxed) == currentArena) {
+        currentArena->free(pointer);
+    } else {
+        release(chunk);
+    }
+    return result;
+}
+
+void GmpAllocator::free(void* pointer, std::size_t size) {
+    frees.fetch_add(1, std::memory_order_relaxed);
+    count(-(long long) size);
+    BlockHeader* header = static_cast<BlockHeader*>(pointer) - 1;
+    Arena::Chunk* chunk = header->chunk;
+    if (chunk == nullptr) {
+        std::free(header);
+    } else if (currentArena != nullptr && chunk->owner.load(std::memory_order_relaxed) == currentArena) {
+        currentArena->free(pointer);
+    } else {
+        release(chunk);
+    }
+}
+
+void GmpAllocator::install() {
+    if (!GmpAllocator::installed) {
+        mp_set_memory_functions(GmpAllocator::allocate, GmpAllocator::reallocate, GmpAllocator::free);
+        GmpAllocator::installed = true;
+    }
+}
+
+bool GmpAllocator::isInstalled() {
+    return GmpAllocator::installed;
+}
+
+unsigned long long GmpAllocator::getAllocations() {
+    return allocations;
+}
+
+unsigned long long GmpAllocator::getReallocations() {
+    return reallocations;
+}
+
+unsigned long long GmpAllocator::getFrees() {
+    return frees;
+}
+
+unsigned long long GmpAllocator::getAllocatedBytes() {
+    return allocatedBytes;
+}
+
+unsigned long long GmpAllocator::getCurrentBytes() {
+    return std::max(0LL, currentBytes.load());
+}
+
+unsigned long long GmpAllocator::getPeakBytes() {
+    return peakBytes;
+}
+
+unsigned long long GmpAllocator::getThreadAllocations() {
+    return threadAllocations;
+}
+
+unsigned long long GmpAllocator::getThreadAllocatedBytes() {
+    return threadAllocatedBytes;
+}
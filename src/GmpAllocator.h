@@ -0,0 +1,55 @@
+#ifndef GMP_ALLOCATOR_H
+#define GMP_ALLOCATOR_H
+
+#include <cstddef>
+
+// Memory functions for GMP with allocation accounting and optional thread-local arenas.
+// install() has to be called before the first GMP number is created, because every block
+// carries a header describing where it comes from.
+//
+// While an Arena object is alive, GMP allocations of its thread are served from large chunks
+// and freed blocks are reused through free lists of power-of-two sizes. Numbers may outlive
+// the arena: a chunk is returned to the system only after the arena is destroyed and the
+// last block allocated from it is freed, possibly by another thread.
+class GmpAllocator {
+public:
+    class Arena {
+    public:
+        struct Chunk;
+    private:
+        static const int NUMBER_OF_SIZE_CLASSES = 16;
+        Arena* previous;
+        Chunk* chunks = nullptr;
+        std::size_t chunkSize;
+        char* position = nullptr;
+        char* end = nullptr;
+        void* freeBlocks[NUMBER_OF_SIZE_CLASSES] = {};
+        void* allocate(std::size_t size);
+        void free(void* block);
+        friend class GmpAllocator;
+    public:
+        explicit Arena(std::size_t chunkSize = 1 << 20);
+        Arena(const Arena&) = delete;
+        Arena& operator = (const Arena&) = delete;
+        ~Arena();
+    };
+private:
+    static bool installed;
+    static void* allocate(std::size_t size);
+    static void* reallocate(void* pointer, std::size_t oldSize, std::size_t newSize);
+    static void free(void* pointer, std::size_t size);
+public:
+    static void install();
+    static bool isInstalled();
+    static unsigned long long getAllocations();
+    static unsigned long long getReallocations();
+    static unsigned long long getFrees();
+    static unsigned long long getAllocatedBytes();
+    static unsigned long long getCurrentBytes();
+    static unsigned long long getPeakBytes();
+    // allocations and bytes allocated by the calling thread, used to attribute memory to stages
+    static unsigned long long getThreadAllocations();
+    static unsigned long long getThreadAllocatedBytes();
+};
+
+#endif //GMP_ALLOCATOR_H
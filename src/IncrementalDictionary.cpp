@@ -0,0 +1,212 @@
+#include <stack>
+#include "IncrementalDictionary.h"
+#include "Statistics.h"
+
+IncrementalDictionary::IncrementalDictionary(DFA* dfa) {
+    this->root = dfa != nullptr ? dfa : new DFA();
+    // states in postorder, so that the successors of a state are counted before it
+    std::vector<DFA*> order;
+    std::stack<std::pair<DFA*, bool>> stateStack;
+    stateStack.emplace(this->root, false);
+    this->inDegree[this->root] = 0;
+    std::unordered_map<DFA*, bool> seen;
+    while (!stateStack.empty()) {
+        auto p = stateStack.top();
+        stateStack.pop();
+        if (p.second) {
+            order.push_back(p.first);
+        } else if (!seen[p.first]) {
+            seen[p.first] = true;
+            stateStack.emplace(p.first, true);
+            for (const auto& q : p.first->getTransitions()) {
+                ++this->inDegree[q.second];
+                if (!seen[q.second]) {
+                    stateStack.emplace(q.second, false);
+                }
+            }
+        }
+    }
+    for (DFA* state : order) {
+        this->updateCounts(state);
+        if (state != this->root) {
+            this->registered.emplace(state->getSignature(), state);
+        }
+    }
+}
+
+IncrementalDictionary::~IncrementalDictionary() {
+    for (const auto& p : this->inDegree) {
+        delete p.first;
+    }
+}
+
+std::vector<DFA*> IncrementalDictionary::getPath(const std::string& word) const {
+    std::vector<DFA*> path = {this->root};
+    for (char c : word) {
+        auto it = path.back()->getTransitions().find(c);
+        if (it == path.back()->getTransitions().end()) {
+            break;
+        }
+        path.push_back(it->second);
+    }
+    return path;
+}
+
+void IncrementalDictionary::makePrivate(std::vector<DFA*>& path, const std::string& word) {
+    std::size_t confluence = 1;
+    while (confluence < path.size() && this->inDegree.at(path[confluence]) == 1) {
+        ++confluence;
+    }
+    // states before the first confluence state are changed in place, so they are unregistered
+    // before any signature changes, and their products are counted again
+    for (std::size_t i = 0; i < confluence; ++i) {
+        if (i > 0) {
+            this->registered.erase(path[i]->getSignature());
+        }
+        for (auto& product : this->products) {
+            product.erase(path[i]);
+        }
+    }
+    // the other states are shared with other words, so the path gets copies of them
+    for (std::size_t i = confluence; i < path.size(); ++i) {
+        DFA* clone = new DFA();
+        clone->setAcceptable(path[i]->isAcceptable());
+        for (const auto& p : path[i]->getTransitions()) {
+            (*clone)[p.first] = p.second;
+            ++this->inDegree[p.second];
+        }
+        (*path[i - 1])[word[i - 1]] = clone;
+        --this->inDegree[path[i]];
+        this->inDegree[clone] = 1;
+        path[i] = clone;
+    }
+    STATISTICS_ADD("incremental.clones", path.size() - confluence);
+}
+
+void IncrementalDictionary::replaceOrRegister(std::vector<DFA*>& path, const std::string& word) {
+    for (std::size_t i = path.size() - 1; i > 0; --i) {
+        DFA* state = path[i];
+        if (!state->isAcceptable() && state->getTransitions().empty()) {
+            path[i - 1]->removeTransition(word[i - 1]);
+            this->release(state);
+            continue;
+        }
+        std::string signature = state->getSignature();
+        auto it = this->registered.find(signature);
+        if (it != this->registered.end()) {
+            (*path[i - 1])[word[i - 1]] = it->second;
+            ++this->inDegree[it->second];
+            this->release(state);
+        } else {
+            this->registered.emplace(signature, state);
+            this->updateCounts(state);
+        }
+    }
+    this->updateCounts(this->root);
+    STATISTICS_ADD("incremental.updated_states", path.size());
+}
+
+void IncrementalDictionary::updateCounts(DFA* state) {
+    std::vector<integer> result(1, state->isAcceptable() ? 1 : 0);
+    for (const auto& p : state->getTransitions()) {
+        const std::vector<integer>& c = this->counts.at(p.second);
+        if (result.size() < c.size() + 1) {
+            result.resize(c.size() + 1, 0);
+        }
+        for (std::size_t n = 0; n < c.size(); ++n) {
+            result[n + 1] += c[n];
+        }
+    }
+    this->counts[state] = std::move(result);
+}
+
+void IncrementalDictionary::release(DFA* state) {
+    for (const auto& p : state->getTransitions()) {
+        --this->inDegree[p.second];
+    }
+    this->counts.erase(state);
+    this->inDegree.erase(state);
+    for (auto& product : this->products) {
+        product.erase(state);
+    }
+    delete state;
+}
+
+bool IncrementalDictionary::contains(const std::string& word) const {
+    std::vector<DFA*> path = this->getPath(word);
+    return path.size() == word.size() + 1 && path.back()->isAcceptable();
+}
+
+bool IncrementalDictionary::insert(const std::string& word) {
+    STATISTICS_TIMER("IncrementalDictionary.insert");
+    std::vector<DFA*> path = this->getPath(word);
+    if (path.size() == word.size() + 1 && path.back()->isAcceptable()) {
+        return false;
+    }
+    this->makePrivate(path, word);
+    for (std::size_t i = path.size() - 1; i < word.size(); ++i) {
+        DFA* state = new DFA();
+        (*path.back())[word[i]] = state;
+        this->inDegree[state] = 1;
+        path.push_back(state);
+    }
+    path.back()->setAcceptable(true);
+    this->replaceOrRegister(path, word);
+    return true;
+}
+
+bool IncrementalDictionary::remove(const std::string& word) {
+    STATISTICS_TIMER("IncrementalDictionary.remove");
+    std::vector<DFA*> path = this->getPath(word);
+    if (path.size() != word.size() + 1 || !path.back()->isAcceptable()) {
+        return false;
+    }
+    this->makePrivate(path, word);
+    path.back()->setAcceptable(false);
+    this->replaceOrRegister(path, word);
+    return true;
+}
+
+DFA* IncrementalDictionary::getAutomaton() const {
+    return this->root;
+}
+
+const std::vector<integer>& IncrementalDictionary::getCounts() const {
+    return this->counts.at(this->root);
+}
+
+unsigned int IncrementalDictionary::addPolicy(const CompiledDFA& policy) {
+    this->policies.push_back(&policy);
+    this->products.emplace_back();
+    return this->policies.size() - 1;
+}
+
+const std::vector<integer>& IncrementalDictionary::countAccepted(unsigned int policy, DFA* state, std::uint32_t q) {
+    // references to the entries stay valid while other entries are inserted
+    std::unordered_map<std::uint32_t, std::vector<integer>>& table = this->products[policy][state];
+    auto it = table.find(q);
+    if (it != table.end()) {
+        return it->second;
+    }
+    const CompiledDFA& automaton = *this->policies[policy];
+    std::vector<integer> result(1, state->isAcceptable() && automaton.isAcceptable(q) ? 1 : 0);
+    for (const auto& p : state->getTransitions()) {
+        std::uint32_t next = automaton.next(q, p.first);
+        if (next == automaton.getDeadState()) {
+            continue;
+        }
+        const std::vector<integer>& c = this->countAccepted(policy, p.second, next);
+        if (result.size() < c.size() + 1) {
+            result.resize(c.size() + 1, 0);
+        }
+        for (std::size_t n = 0; n < c.size(); ++n) {
+            result[n + 1] += c[n];
+        }
+    }
+    STATISTICS_ADD("incremental.product_entries", 1);
+    return table.emplace(q, std::move(result)).first->second;
+}
+
+std::vector<integer> IncrementalDictionary::getAcceptedCounts(unsigned int policy) {
+    return this->countAccepted(policy, this->root, this->policies[policy]->getStartState());
+}
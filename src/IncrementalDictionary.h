@@ -0,0 +1,58 @@
+#ifndef INCREMENTAL_DICTIONARY_H
+#define INCREMENTAL_DICTIONARY_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DFA.h"
+#include "CompiledDFA.h"
+
+// Minimal acyclic automaton of a finite set of words kept minimal under insertions and
+// removals (Carrasco and Forcada). Only the states on the path of the changed word are touched:
+// the path is made private by cloning it from the first state with several incoming
+// transitions, changed, and its states are merged with equivalent registered ones bottom-up.
+//
+// The numbers of words of every length from every state are kept up to date in the same pass,
+// and so are the products with attached policies: a state whose language did not change keeps
+// its entries, so after an update only the pairs with states of the new path are recounted.
+class IncrementalDictionary {
+private:
+    DFA* root;
+    // all states except the root, by signature
+    std::unordered_map<std::string, DFA*> registered;
+    std::unordered_map<DFA*, unsigned int> inDegree;
+    // counts[state][n] is the number of words of length n leading from the state to acceptance
+    std::unordered_map<DFA*, std::vector<integer>> counts;
+    std::vector<const CompiledDFA*> policies;
+    // products[i][state][q][n] is the number of such words also leading from q to acceptance in
+    // the policy i
+    std::vector<std::unordered_map<DFA*, std::unordered_map<std::uint32_t, std::vector<integer>>>> products;
+    std::vector<DFA*> getPath(const std::string& word) const;
+    void makePrivate(std::vector<DFA*>& path, const std::string& word);
+    void replaceOrRegister(std::vector<DFA*>& path, const std::string& word);
+    void updateCounts(DFA* state);
+    void release(DFA* state);
+    const std::vector<integer>& countAccepted(unsigned int policy, DFA* state, std::uint32_t q);
+public:
+    // takes the ownership of a minimal acyclic automaton, e.g. from
+    // DictionaryAutomaton::fromSortedWords or from minimize() of a finite language; an empty
+    // dictionary if dfa is nullptr
+    explicit IncrementalDictionary(DFA* dfa = nullptr);
+    IncrementalDictionary(const IncrementalDictionary&) = delete;
+    IncrementalDictionary& operator = (const IncrementalDictionary&) = delete;
+    ~IncrementalDictionary();
+    bool contains(const std::string& word) const;
+    // false if nothing changed
+    bool insert(const std::string& word);
+    bool remove(const std::string& word);
+    DFA* getAutomaton() const;
+    // the number of words of every length
+    const std::vector<integer>& getCounts() const;
+    // the policy has to outlive the dictionary
+    unsigned int addPolicy(const CompiledDFA& policy);
+    // the number of words of every length in the dictionary accepted by the policy
+    std::vector<integer> getAcceptedCounts(unsigned int policy);
+};
+
+#endif //INCREMENTAL_DICTIONARY_H
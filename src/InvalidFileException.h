@@ -0,0 +1,12 @@
+#ifndef INVALID_FILE_EXCEPTION_H
+#define INVALID_FILE_EXCEPTION_H
+
+#include <exception>
+
+struct InvalidFileException : public std::exception {
+   const char* what() const noexcept override {
+      return "Error: File cannot be read or has an invalid format.\n";
+   }
+};
+
+#endif //INVALID_FILE_EXCEPTION_H
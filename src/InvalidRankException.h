@@ -0,0 +1,12 @@
+#ifndef INVALID_RANK_EXCEPTION_H
+#define INVALID_RANK_EXCEPTION_H
+
+#include <exception>
+
+struct InvalidRankException : public std::exception {
+   const char* what() const noexcept override {
+      return "Error: Length or rank out of range.\n";
+   }
+};
+
+#endif //INVALID_RANK_EXCEPTION_H
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <unordered_map>
+#include "LanguageComparison.h"
+#include "Statistics.h"
+
+// the word leading to node from the initial one, given the parents and letters of all nodes
+static std::string getWord(const std::vector<int>& parents, const std::vector<char>& letters, int node) {
+    std::string word;
+    for (; parents[node] >= 0; node = parents[node]) {
+        word.push_back(letters[node]);
+    }
+    std::reverse(word.begin(), word.end());
+    return word;
+}
+
+bool LanguageComparison::areEquivalent(DFA* a, DFA* b, std::string& counterexample) {
+    STATISTICS_TIMER("areEquivalent");
+    // states of both automata share the union-find structure, nullptr stands for the dead state
+    std::unordered_map<DFA*, unsigned int> indices = {{nullptr, 0}};
+    std::vector<unsigned int> representative = {0};
+    auto getIndex = [&](DFA* state) {
+        auto inserted = indices.emplace(state, representative.size());
+        if (inserted.second) {
+            representative.push_back(representative.size());
+        }
+        return inserted.first->second;
+    };
+    auto find = [&](unsigned int i) {
+        while (representative[i] != i) {
+            representative[i] = representative[representative[i]];
+            i = representative[i];
+        }
+        return i;
+    };
+    std::vector<std::pair<DFA*, DFA*>> pairs = {{a, b}};
+    std::vector<int> parents = {-1};
+    std::vector<char> letters = {'\0'};
+    unsigned int first = getIndex(a);
+    representative[getIndex(b)] = first;
+    for (std::size_t i = 0; i < pairs.size(); ++i) {
+        DFA* p = pairs[i].first;
+        DFA* q = pairs[i].second;
+        if ((p != nullptr && p->isAcceptable()) != (q != nullptr && q->isAcceptable())) {
+            counterexample = getWord(parents, letters, i);
+            STATISTICS_SET("areEquivalent.pairs", pairs.size());
+            return false;
+        }
+        std::string alphabet;
+        for (DFA* state : {p, q}) {
+            if (state != nullptr) {
+                for (const auto& t : state->getTransitions()) {
+                    alphabet.push_back(t.first);
+                }
+            }
+        }
+        std::sort(alphabet.begin(), alphabet.end());
+        alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+        for (char c : alphabet) {
+            DFA* nextP = nullptr;
+            DFA* nextQ = nullptr;
+            if (p != nullptr && p->getTransitions().count(c) > 0) {
+                nextP = p->getTransitions().at(c);
+            }
+            if (q != nullptr && q->getTransitions().count(c) > 0) {
+                nextQ = q->getTransitions().at(c);
+            }
+            unsigned int x = find(getIndex(nextP));
+            unsigned int y = find(getIndex(nextQ));
+            if (x != y) {
+                representative[y] = x;
+                pairs.emplace_back(nextP, nextQ);
+                parents.push_back(i);
+                letters.push_back(c);
+            }
+        }
+    }
+    STATISTICS_SET("areEquivalent.pairs", pairs.size());
+    return true;
+}
+
+bool LanguageComparison::isIncluded(NFA* a, NFA* b, std::string& counterexample) {
+    STATISTICS_TIMER("isIncluded");
+    std::vector<NFA*> statesOfA = a->getStates();
+    std::vector<NFA*> statesOfB = b->getStates();
+    auto isRejecting = [&](const std::vector<unsigned int>& subset) {
+        for (unsigned int i : subset) {
+            if (statesOfB[i]->isAcceptable()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    // nodes[i] is a pair (index of a state of a, sorted indices of states of b), antichains[p]
+    // are the indices of the nodes with the state p whose sets are minimal
+    std::vector<std::pair<unsigned int, std::vector<unsigned int>>> nodes = {{0, {0}}};
+    std::vector<int> parents = {-1};
+    std::vector<char> letters = {'\0'};
+    std::vector<std::vector<unsigned int>> antichains(statesOfA.size());
+    antichains[0].push_back(0);
+    auto isSubsumed = [&](unsigned int p, const std::vector<unsigned int>& subset) {
+        for (unsigned int node : antichains[p]) {
+            const std::vector<unsigned int>& other = nodes[node].second;
+            if (std::includes(subset.begin(), subset.end(), other.begin(), other.end())) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        NFA* p = statesOfA[nodes[i].first];
+        if (p->isAcceptable() && isRejecting(nodes[i].second)) {
+            counterexample = getWord(parents, letters, i);
+            STATISTICS_SET("isIncluded.pairs", nodes.size());
+            return false;
+        }
+        for (const auto& t : p->getTransitions()) {
+            std::vector<unsigned int> next;
+            for (unsigned int j : nodes[i].second) {
+                auto it = statesOfB[j]->getTransitions().find(t.first);
+                if (it != statesOfB[j]->getTransitions().end()) {
+                    for (NFA* r : it->second) {
+                        next.push_back(r->getIndex());
+                    }
+                }
+            }
+            std::sort(next.begin(), next.end());
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+            for (NFA* r : t.second) {
+                unsigned int nextP = r->getIndex();
+                if (isSubsumed(nextP, next)) {
+                    continue;
+                }
+                // the larger sets are no longer minimal, but they may still be explored
+                std::vector<unsigned int>& antichain = antichains[nextP];
+                antichain.erase(std::remove_if(antichain.begin(), antichain.end(), [&](unsigned int node) {
+                    const std::vector<unsigned int>& other = nodes[node].second;
+                    return std::includes(other.begin(), other.end(), next.begin(), next.end());
+                }), antichain.end());
+                antichain.push_back(nodes.size());
+                nodes.emplace_back(nextP, next);
+                parents.push_back(i);
+                letters.push_back(t.first);
+            }
+        }
+    }
+    STATISTICS_SET("isIncluded.pairs", nodes.size());
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef LANGUAGE_COMPARISON_H
+#define LANGUAGE_COMPARISON_H
+
+#include <string>
+#include "DFA.h"
+#include "NFA.h"
+
+// Equality and inclusion of the languages of two automata without minimizing them. Both
+// searches go breadth-first, so on failure the word found is a shortest one telling the
+// languages apart.
+class LanguageComparison {
+public:
+    // Hopcroft and Karp: pairs of states reached by the same word are merged in a union-find
+    // structure, a pair whose states are already in one class is implied by the others and is
+    // not explored; true if the languages are equal, otherwise counterexample is set to a
+    // shortest word accepted by exactly one of the automata
+    static bool areEquivalent(DFA* a, DFA* b, std::string& counterexample);
+    // both automata ε-free; explores the pairs of a state of a and the set of states of b reached
+    // by the same word, skipping a pair if a pair with the same state and a subset of its set has
+    // been seen (an antichain), since every word rejected from the larger set is rejected from the
+    // smaller one too, so b is not determinized; true if every word accepted by a is accepted by
+    // b, otherwise counterexample is set to a shortest word accepted by a and not by b
+    static bool isIncluded(NFA* a, NFA* b, std::string& counterexample);
+};
+
+#endif //LANGUAGE_COMPARISON_H
@@ -0,0 +1,120 @@
+#include <cstring>
+#include "LazyDFA.h"
+#include "Statistics.h"
+
+LazyDFA::LazyDFA(NFA* _nfa, unsigned int _maximumNumberOfStates) : nfa(_nfa), maximumNumberOfStates(std::max(2u, _maximumNumberOfStates)) {
+    bool used[256] = {};
+    for (NFA* q : _nfa->getStates()) {
+        for (const auto& p : q->getTransitions()) {
+            used[(unsigned char) p.first] = true;
+        }
+    }
+    for (int c = 0; c < 256; ++c) {
+        if (used[c]) {
+            this->symbols[this->numberOfColumns] = (char) c;
+            ++this->numberOfColumns;
+        }
+    }
+    std::memset(this->alphabet, this->numberOfColumns, sizeof(this->alphabet));
+    for (unsigned int i = 0; i < this->numberOfColumns; ++i) {
+        this->alphabet[(unsigned char) this->symbols[i]] = i;
+    }
+    this->cache = this->newCache();
+}
+
+std::shared_ptr<LazyDFA::Cache> LazyDFA::newCache() const {
+    std::shared_ptr<Cache> result = std::make_shared<Cache>();
+    result->states.reset(new std::unique_ptr<State>[this->maximumNumberOfStates]);
+    std::vector<Word> start(this->nfa.getNumberOfWords());
+    this->nfa.getStartSet(start.data());
+    this->add(*result, start);
+    return result;
+}
+
+// called with the mutex of the cache held or before the cache is shared, returns UNKNOWN if
+// the cache is full
+std::uint32_t LazyDFA::add(Cache& _cache, const std::vector<Word>& set) const {
+    std::string key(reinterpret_cast<const char*>(set.data()), set.size() * sizeof(Word));
+    auto it = _cache.ids.find(key);
+    if (it != _cache.ids.end()) {
+        return it->second;
+    }
+    if (_cache.numberOfStates == this->maximumNumberOfStates) {
+        return UNKNOWN;
+    }
+    State* state = new State();
+    state->set = set;
+    state->acceptable = this->nfa.isAcceptable(set.data());
+    state->transitions.reset(new std::atomic<std::uint32_t>[this->numberOfColumns]);
+    for (unsigned int i = 0; i < this->numberOfColumns; ++i) {
+        state->transitions[i].store(UNKNOWN, std::memory_order_relaxed);
+    }
+    std::uint32_t id = _cache.numberOfStates;
+    _cache.states[id].reset(state);
+    _cache.ids.emplace(std::move(key), id);
+    ++_cache.numberOfStates;
+    STATISTICS_ADD("lazy_dfa.states", 1);
+    return id;
+}
+
+unsigned int LazyDFA::getNumberOfStates() const {
+    std::shared_ptr<Cache> current = std::atomic_load(&this->cache);
+    std::lock_guard<std::mutex> lock(current->mutex);
+    return current->numberOfStates;
+}
+
+bool LazyDFA::regexMatch(const std::string& word) {
+    std::vector<Word> buffer;
+    return this->regexMatch(word.data(), word.size(), buffer);
+}
+
+bool LazyDFA::regexMatch(const char* word, std::size_t length, std::vector<Word>& next) {
+    std::shared_ptr<Cache> current = std::atomic_load(&this->cache);
+    std::uint32_t state = 0;
+    unsigned int flushes = 0;
+    next.resize(this->nfa.getNumberOfWords());
+    for (std::size_t i = 0; i < length; ++i) {
+        std::uint32_t column = this->alphabet[(unsigned char) word[i]];
+        if (column == this->numberOfColumns) {
+            return false;
+        }
+        // states are published before the transitions leading to them, see below
+        std::uint32_t target = current->states[state]->transitions[column].load(std::memory_order_acquire);
+        if (target == UNKNOWN) {
+            const State& s = *current->states[state];
+            if (!this->nfa.step(s.set.data(), word[i], next.data())) {
+                target = DEAD;
+            } else {
+                std::lock_guard<std::mutex> lock(current->mutex);
+                target = this->add(*current, next);
+            }
+            if (target != UNKNOWN) {
+                s.transitions[column].store(target, std::memory_order_release);
+            } else if (++flushes > MAXIMUM_FLUSHES_PER_WORD) {
+                // the word visits too many subsets to be worth caching
+                STATISTICS_ADD("lazy_dfa.nfa_fallbacks", 1);
+                std::vector<Word> states = next;
+                for (++i; i < length; ++i) {
+                    if (!this->nfa.step(states.data(), word[i], next.data())) {
+                        return false;
+                    }
+                    states.swap(next);
+                }
+                return this->nfa.isAcceptable(states.data());
+            } else {
+                STATISTICS_ADD("lazy_dfa.flushes", 1);
+                std::shared_ptr<Cache> fresh = this->newCache();
+                target = this->add(*fresh, next);
+                // if another thread has flushed in the meantime, its cache is kept and this one
+                // is used only for the rest of the word
+                std::atomic_compare_exchange_strong(&this->cache, &current, fresh);
+                current = fresh;
+            }
+        }
+        if (target == DEAD) {
+            return false;
+        }
+        state = target;
+    }
+    return current->states[state]->acceptable;
+}
@@ -0,0 +1,62 @@
+#ifndef LAZY_DFA_H
+#define LAZY_DFA_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "NFA.h"
+#include "BitParallelNFA.h"
+
+// DFA built on demand while matching: a state is a set of states of a BitParallelNFA and is
+// created the first time a word reaches it. At most maximumNumberOfStates states are kept;
+// when the cache is full it is flushed and started again. A word that causes more than
+// MAXIMUM_FLUSHES_PER_WORD flushes is finished by plain NFA simulation.
+//
+// Matching is safe from many threads. Known transitions are read without locking, only
+// creating a state takes the mutex of the cache. A flush installs a new cache, threads still
+// using the old one keep it alive through their shared_ptr.
+class LazyDFA {
+public:
+    typedef BitParallelNFA::Word Word;
+    static const unsigned int DEFAULT_MAXIMUM_NUMBER_OF_STATES = 1 << 12;
+    static const unsigned int MAXIMUM_FLUSHES_PER_WORD = 3;
+private:
+    static const std::uint32_t UNKNOWN = 0xffffffff;
+    static const std::uint32_t DEAD = 0xfffffffe;
+    struct State {
+        std::vector<Word> set;
+        bool acceptable;
+        std::unique_ptr<std::atomic<std::uint32_t>[]> transitions;
+    };
+    struct Cache {
+        std::unique_ptr<std::unique_ptr<State>[]> states;
+        std::uint32_t numberOfStates = 0;
+        std::unordered_map<std::string, std::uint32_t> ids;
+        std::mutex mutex;
+    };
+    BitParallelNFA nfa;
+    unsigned int maximumNumberOfStates;
+    // column of every symbol, symbols without transitions in the NFA have column numberOfColumns
+    std::uint8_t alphabet[256];
+    unsigned int numberOfColumns = 0;
+    char symbols[256];
+    std::shared_ptr<Cache> cache;
+    std::shared_ptr<Cache> newCache() const;
+    std::uint32_t add(Cache& cache, const std::vector<Word>& set) const;
+public:
+    // nfa has to be ε-free, see NFA::removeEpsilonTransitions
+    explicit LazyDFA(NFA* nfa, unsigned int maximumNumberOfStates = DEFAULT_MAXIMUM_NUMBER_OF_STATES);
+    LazyDFA(const LazyDFA&) = delete;
+    LazyDFA& operator = (const LazyDFA&) = delete;
+    // number of states in the current cache
+    unsigned int getNumberOfStates() const;
+    bool regexMatch(const std::string& word);
+    // buffer is scratch space, reusing it between the words of one thread saves an allocation
+    bool regexMatch(const char* word, std::size_t length, std::vector<Word>& buffer);
+};
+
+#endif //LAZY_DFA_H
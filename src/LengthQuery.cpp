@@ -0,0 +1,252 @@
+#include <cmath>
+#include <vector>
+#include "LengthQuery.h"
+#include "Statistics.h"
+
+LengthQuery::LengthQuery(const Function& _f, const ExtendedRationalFunction<integer>& e) : f(_f), asymptotics(e), restLength(e.getRest().getCoefficients().size()) {
+    typedef Rational<integer> Number;
+    this->cumulative = Function(_f.getNumerator(), _f.getDenominator() * Polynomial<Number>({Number(1), Number(-1)}), false);
+}
+
+integer LengthQuery::coefficient(const Function& f, unsigned long long n) {
+    STATISTICS_TIMER("coefficient");
+    // both polynomials are scaled to integer coefficients, which does not change P / Q
+    integer scale = 1;
+    std::vector<Rational<integer>> numeratorCoefficients = f.getNumerator().getCoefficients();
+    std::vector<Rational<integer>> denominatorCoefficients = f.getDenominator().getCoefficients();
+    for (const std::vector<Rational<integer>>* a : {&numeratorCoefficients, &denominatorCoefficients}) {
+        for (const Rational<integer>& c : *a) {
+            scale = lcm(scale, c.getDenominator());
+        }
+    }
+    std::vector<integer> p, q;
+    for (const Rational<integer>& c : numeratorCoefficients) {
+        p.push_back(c.getNumerator() * (scale / c.getDenominator()));
+    }
+    for (const Rational<integer>& c : denominatorCoefficients) {
+        q.push_back(c.getNumerator() * (scale / c.getDenominator()));
+    }
+    Polynomial<integer> numerator(p), denominator(q);
+    while (n > 0 && numerator != Polynomial<integer>()) {
+        // Q(x)Q(-x) is even, so P(x)Q(-x) / Q(x)Q(-x) splits into halves of the coefficients
+        std::vector<integer> c = denominator.getCoefficients();
+        for (std::size_t i = 1; i < c.size(); i += 2) {
+            c[i] = -c[i];
+        }
+        Polynomial<integer> minus(c);
+        std::vector<integer> u = (numerator * minus).getCoefficients();
+        std::vector<integer> v = (denominator * minus).getCoefficients();
+        std::vector<integer> nextNumerator, nextDenominator;
+        for (std::size_t i = n % 2; i < u.size(); i += 2) {
+            nextNumerator.push_back(u[i]);
+        }
+        for (std::size_t i = 0; i < v.size(); i += 2) {
+            nextDenominator.push_back(v[i]);
+        }
+        numerator = Polynomial<integer>(nextNumerator);
+        denominator = Polynomial<integer>(nextDenominator);
+        n /= 2;
+    }
+    if (numerator == Polynomial<integer>()) {
+        return 0;
+    }
+    // [x^0] P/Q = P(0) / Q(0)
+    return numerator.getCoefficients()[0] / denominator.getCoefficients()[0];
+}
+
+integer LengthQuery::count(unsigned long long n) const {
+    return coefficient(this->f, n);
+}
+
+integer LengthQuery::cumulativeCount(unsigned long long n) const {
+    return coefficient(this->cumulative, n);
+}
+
+long long LengthQuery::minimumLength(const integer& target) const {
+    if (target <= 0) {
+        return 0;
+    }
+    // lengths inside the polynomial part are checked one by one
+    for (unsigned long long n = 0; n < this->restLength; ++n) {
+        if (this->count(n) >= target) {
+            return n;
+        }
+    }
+    if (this->asymptotics.isFinite()) {
+        return -1;
+    }
+    // beyond the polynomial part count(n) <= 2^bound(n) with bound non-decreasing, so all n
+    // below the first one with 2^bound(n) >= target are skipped
+    long double log2Target = std::log2(target.get_d());
+    auto reachable = [&](unsigned long long n) {
+        return this->asymptotics.getLog2MonotoneBound(n) + 1e-6L >= log2Target;
+    };
+    unsigned long long low = this->restLength, high = std::max(this->restLength, 1ULL);
+    while (!reachable(high)) {
+        if (high > (1ULL << 62)) {
+            return -1;
+        }
+        high *= 2;
+    }
+    while (low < high) {
+        unsigned long long middle = low + (high - low) / 2;
+        if (reachable(middle)) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    STATISTICS_SET("minimumLength.bracket", low);
+    // the counts may fall far behind the bound, e.g. polynomially growing ones, and need not grow
+    // along every residue class, so each class is searched with exact counts. Along a class modulo
+    // the period a_n = ρ^(-n) D(n) + E(n), where D, from the poles on |z| = ρ, is a polynomial
+    // and |E(n)| <= ρ^(-n) B(n) comes from the poles further away. Once D grows over a period by
+    // more than the error at both ends, the counts of the class do not decrease any more.
+    const unsigned long long limit = 1ULL << 62;
+    unsigned long long period = this->asymptotics.getPeriod();
+    long double rhoPower = std::pow(this->asymptotics.getGrowthRate(), -(long double) period);
+    auto increasing = [&](unsigned long long n) {
+        // ρ^(n + period) (a_(n + period) - a_n) >= D(n + period) - ρ^period D(n) - B(n + period) - ρ^period B(n)
+        return this->asymptotics.getScaledDominantPart(n + period) - rhoPower * this->asymptotics.getScaledDominantPart(n)
+               > this->asymptotics.getScaledOuterErrorBound(n + period) + rhoPower * this->asymptotics.getScaledOuterErrorBound(n);
+    };
+    // log2 of the bound on |E(n)|
+    auto log2Error = [&](unsigned long long n) {
+        return std::log2(this->asymptotics.getScaledOuterErrorBound(n)) + n * this->asymptotics.getEntropyRate();
+    };
+    // the smallest k in [lowK, highK] with count(first + period * k) >= target, given that highK is one
+    auto bisect = [&](unsigned long long first, unsigned long long lowK, unsigned long long highK) {
+        while (lowK < highK) {
+            unsigned long long middle = lowK + (highK - lowK) / 2;
+            if (this->count(first + period * middle) >= target) {
+                highK = middle;
+            } else {
+                lowK = middle + 1;
+            }
+        }
+        return first + period * lowK;
+    };
+    // the best length found so far, limit + 1 while there is none
+    unsigned long long best = limit + 1;
+    struct Search {
+        unsigned long long first;
+        unsigned long long lowK;
+        unsigned long long highK;
+        unsigned long long step;
+    };
+    std::vector<Search> searches;
+    std::vector<unsigned long long> flatClasses;
+    for (unsigned long long r = 0; r < period && low + r <= limit; ++r) {
+        unsigned long long first = low + r;
+        unsigned long long maximumK = (limit - first) / period;
+        // the first k with increasing(first + period * k), by galloping and bisection
+        unsigned long long lowK = 0, highK = 0, step = 1;
+        while (!increasing(first + period * highK) && highK < maximumK) {
+            lowK = highK + 1;
+            highK = maximumK - highK > step ? highK + step : maximumK;
+            step *= 2;
+        }
+        if (!increasing(first + period * highK)) {
+            flatClasses.push_back(first);
+            continue;
+        }
+        while (lowK < highK) {
+            unsigned long long middle = lowK + (highK - lowK) / 2;
+            if (increasing(first + period * middle)) {
+                highK = middle;
+            } else {
+                lowK = middle + 1;
+            }
+        }
+        // below the first increasing length the counts are checked one by one
+        unsigned long long k = 0;
+        for (; k < lowK && first + period * k < best; ++k) {
+            if (this->count(first + period * k) >= target) {
+                best = first + period * k;
+                break;
+            }
+        }
+        if (k == lowK && first + period * k < best) {
+            searches.push_back({first, k, k, 1});
+        }
+    }
+    // from there on the increasing classes are searched together, at k = k0, k0 + 1, k0 + 3,
+    // k0 + 7, ... until the target is reached, then by bisection between the last two, so that
+    // no class is probed far beyond the best length found in the others
+    while (!searches.empty()) {
+        std::vector<Search> next;
+        for (Search s : searches) {
+            if (s.first + period * s.lowK >= best) {
+                continue;
+            }
+            if (s.first + period * s.highK >= best) {
+                s.highK = (best - 1 - s.first) / period;
+                if (this->count(s.first + period * s.highK) >= target) {
+                    best = bisect(s.first, s.lowK, s.highK);
+                }
+                continue;
+            }
+            if (this->count(s.first + period * s.highK) >= target) {
+                best = bisect(s.first, s.lowK, s.highK);
+                continue;
+            }
+            unsigned long long maximumK = (limit - s.first) / period;
+            if (s.highK == maximumK) {
+                continue;
+            }
+            s.lowK = s.highK + 1;
+            s.highK = maximumK - s.highK > s.step ? s.highK + s.step : maximumK;
+            s.step *= 2;
+            next.push_back(s);
+        }
+        searches.swap(next);
+    }
+    // in the other classes D is constant or 0, they are checked one by one up to the best length
+    // or until the error stays below 1/2, when the counts settle at D
+    for (unsigned long long first : flatClasses) {
+        for (unsigned long long n = first; n < best; n += period) {
+            if (this->count(n) >= target) {
+                best = n;
+                break;
+            }
+            if (log2Error(n) < -1 && log2Error(n + period) <= log2Error(n)) {
+                break;
+            }
+        }
+    }
+    STATISTICS_SET("minimumLength.period", period);
+    return best > limit ? -1 : (long long) best;
+}
+
+long long LengthQuery::minimumCumulativeLength(const integer& target) const {
+    if (target <= 0) {
+        return 0;
+    }
+    // the cumulative count never decreases, the first guess comes from the growth rate
+    unsigned long long low = 0, high;
+    if (this->asymptotics.isFinite()) {
+        high = this->restLength;
+        if (this->cumulativeCount(high) < target) {
+            return -1;
+        }
+    } else {
+        long double rate = this->asymptotics.getEntropyRate();
+        high = rate > 0.01L ? (unsigned long long) std::ceil(std::log2(target.get_d()) / rate) + 1 : 1;
+        while (this->cumulativeCount(high) < target) {
+            if (high > (1ULL << 62)) {
+                return -1;
+            }
+            low = high + 1;
+            high *= 2;
+        }
+    }
+    while (low < high) {
+        unsigned long long middle = low + (high - low) / 2;
+        if (this->cumulativeCount(middle) >= target) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
@@ -0,0 +1,38 @@
+#ifndef LENGTH_QUERY_H
+#define LENGTH_QUERY_H
+
+#include "DFA.h"
+#include "RationalFunction.h"
+#include "ExtendedRationalFunction.h"
+#include "Asymptotics.h"
+
+// Queries like "what length gives at least T words". Single coefficients are computed exactly
+// in O(M(d) log n) by Fiduccia's halving [x^n] P(x)/Q(x) = [x^(n/2)] (P(x)Q(-x))_(n mod 2) / Q(x)Q(-x)_0,
+// so the series is never expanded term by term. The search is bracketed by the asymptotic
+// estimate: no length with a bound from Asymptotics below T needs an exact count. From there on
+// every residue class modulo the period of the poles on |z| = ρ is searched on its own: one by one
+// below the length from which the error bounds show that its counts do not decrease, by
+// galloping and bisection above it.
+class LengthQuery {
+public:
+    typedef RationalFunction<Rational<integer>> Function;
+private:
+    Function f;
+    Function cumulative;
+    Asymptotics asymptotics;
+    // number of coefficients of the polynomial part of f
+    unsigned long long restLength;
+    static integer coefficient(const Function& f, unsigned long long n);
+public:
+    LengthQuery(const Function& f, const ExtendedRationalFunction<integer>& e);
+    // number of words of length n
+    integer count(unsigned long long n) const;
+    // number of words of length at most n, the coefficient of f / (1 - x)
+    integer cumulativeCount(unsigned long long n) const;
+    // the smallest n with count(n) >= target, -1 if there is none or if it exceeds 2^62
+    long long minimumLength(const integer& target) const;
+    // the smallest n with cumulativeCount(n) >= target, -1 if there is none or if it exceeds 2^62
+    long long minimumCumulativeLength(const integer& target) const;
+};
+
+#endif //LENGTH_QUERY_H
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include "LevenshteinAutomaton.h"
+#include "VectorHash.h"
+#include "Statistics.h"
+
+DFA* LevenshteinAutomaton::neighbourhood(DFA* dfa, unsigned int k, std::string alphabet, unsigned int maximumNumberOfStates) {
+    STATISTICS_TIMER("levenshtein");
+    // every letter once, so that the transitions of a subset are built once per letter
+    std::sort(alphabet.begin(), alphabet.end());
+    alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+    // states of dfa by index, without the states from which no word is accepted, since an
+    // error cannot make them useful
+    std::unordered_map<DFA*, unsigned int> indices = {{dfa, 0}};
+    std::vector<DFA*> states = {dfa};
+    std::vector<std::vector<unsigned int>> predecessors(1);
+    bool letters[256] = {};
+    for (unsigned int i = 0; i < states.size(); ++i) {
+        for (const auto& p : states[i]->getTransitions()) {
+            auto inserted = indices.emplace(p.second, states.size());
+            if (inserted.second) {
+                states.push_back(p.second);
+                predecessors.emplace_back();
+            }
+            predecessors[inserted.first->second].push_back(i);
+            letters[(unsigned char) p.first] = true;
+        }
+    }
+    std::vector<bool> alive(states.size(), false);
+    std::queue<unsigned int> queue;
+    for (unsigned int i = 0; i < states.size(); ++i) {
+        if (states[i]->isAcceptable()) {
+            alive[i] = true;
+            queue.push(i);
+        }
+    }
+    while (!queue.empty()) {
+        unsigned int i = queue.front();
+        queue.pop();
+        for (unsigned int j : predecessors[i]) {
+            if (!alive[j]) {
+                alive[j] = true;
+                queue.push(j);
+            }
+        }
+    }
+    std::vector<std::vector<std::pair<char, unsigned int>>> successors(states.size());
+    for (unsigned int i = 0; i < states.size(); ++i) {
+        for (const auto& p : states[i]->getTransitions()) {
+            unsigned int j = indices[p.second];
+            if (alive[j]) {
+                successors[i].emplace_back(p.first, j);
+            }
+        }
+    }
+    if (alphabet.empty()) {
+        for (int c = 1; c < 256; ++c) {
+            if (letters[c]) {
+                alphabet.push_back((char) c);
+            }
+        }
+    }
+
+    // a subset is a sorted vector of q * (k + 1) + e for the fewest errors e with which the
+    // state q is reached; best[q] is that number in the subset being built, k + 1 if q is absent
+    std::vector<unsigned int> best(states.size(), k + 1);
+    std::vector<unsigned int> touched;
+    std::vector<std::vector<unsigned int>> buckets(k + 1);
+    auto add = [&](unsigned int q, unsigned int e) {
+        if (e < best[q]) {
+            if (best[q] == k + 1) {
+                touched.push_back(q);
+            }
+            best[q] = e;
+            buckets[e].push_back(q);
+        }
+    };
+    // deletions skip letters of the language without reading anything
+    auto close = [&]() {
+        for (unsigned int e = 0; e < k; ++e) {
+            for (std::size_t i = 0; i < buckets[e].size(); ++i) {
+                unsigned int q = buckets[e][i];
+                if (best[q] == e) {
+                    for (const auto& p : successors[q]) {
+                        add(p.second, e + 1);
+                    }
+                }
+            }
+        }
+        std::vector<unsigned int> subset;
+        subset.reserve(touched.size());
+        for (unsigned int q : touched) {
+            subset.push_back(q * (k + 1) + best[q]);
+            best[q] = k + 1;
+        }
+        touched.clear();
+        for (std::vector<unsigned int>& bucket : buckets) {
+            bucket.clear();
+        }
+        std::sort(subset.begin(), subset.end());
+        return subset;
+    };
+
+    std::unordered_map<std::vector<unsigned int>, DFA*, VectorHash<unsigned int>> subsets;
+    std::queue<const std::vector<unsigned int>*> frontier;
+    bool exceeded = false;
+    auto getState = [&](std::vector<unsigned int>&& subset) -> DFA* {
+        auto inserted = subsets.emplace(std::move(subset), nullptr);
+        if (inserted.second) {
+            auto* state = new DFA();
+            for (unsigned int entry : inserted.first->first) {
+                if (states[entry / (k + 1)]->isAcceptable()) {
+                    state->setAcceptable(true);
+                    break;
+                }
+            }
+            inserted.first->second = state;
+            frontier.push(&inserted.first->first);
+            exceeded |= subsets.size() > maximumNumberOfStates;
+        }
+        return inserted.first->second;
+    };
+    if (alive[0]) {
+        add(0, 0);
+    }
+    DFA* start = getState(close());
+    bool isLetter[256] = {};
+    while (!frontier.empty() && !exceeded) {
+        const std::vector<unsigned int>& subset = *frontier.front();
+        frontier.pop();
+        DFA* state = subsets.at(subset);
+        std::fill(isLetter, isLetter + 256, false);
+        for (unsigned int entry : subset) {
+            for (const auto& p : successors[entry / (k + 1)]) {
+                isLetter[(unsigned char) p.first] = true;
+            }
+        }
+        // every letter not on a transition of the subset is read by an insertion or a
+        // substitution only, so all of them lead to the same subset
+        DFA* other = nullptr;
+        bool otherComputed = false;
+        for (char c : alphabet) {
+            if (!isLetter[(unsigned char) c] && otherComputed) {
+                if (other != nullptr) {
+                    (*state)[c] = other;
+                }
+                continue;
+            }
+            for (unsigned int entry : subset) {
+                unsigned int q = entry / (k + 1);
+                unsigned int e = entry % (k + 1);
+                if (e < k) {
+                    add(q, e + 1);
+                }
+                for (const auto& p : successors[q]) {
+                    if (p.first == c) {
+                        add(p.second, e);
+                    } else if (e < k) {
+                        add(p.second, e + 1);
+                    }
+                }
+            }
+            std::vector<unsigned int> next = close();
+            DFA* target = next.empty() ? nullptr : getState(std::move(next));
+            if (!isLetter[(unsigned char) c]) {
+                other = target;
+                otherComputed = true;
+            }
+            if (target != nullptr) {
+                (*state)[c] = target;
+            }
+        }
+    }
+    STATISTICS_SET("levenshtein.states", subsets.size());
+    if (exceeded) {
+        for (const auto& p : subsets) {
+            delete p.second;
+        }
+        return nullptr;
+    }
+    return start;
+}
+
+DFA* LevenshteinAutomaton::ofWord(const std::string& word, unsigned int k, const std::string& alphabet) {
+    std::vector<DFA*> path = {new DFA()};
+    for (char c : word) {
+        DFA* state = new DFA();
+        (*path.back())[c] = state;
+        path.push_back(state);
+    }
+    path.back()->setAcceptable(true);
+    DFA* result = neighbourhood(path[0], k, alphabet);
+    for (DFA* state : path) {
+        delete state;
+    }
+    return result;
+}
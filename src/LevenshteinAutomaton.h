@@ -0,0 +1,25 @@
+#ifndef LEVENSHTEIN_AUTOMATON_H
+#define LEVENSHTEIN_AUTOMATON_H
+
+#include <climits>
+#include <string>
+#include "DFA.h"
+
+// Automata of the words within a Levenshtein distance of a language: a word is accepted if at
+// most k insertions, deletions and substitutions of letters turn it into a word of the
+// language. The neighbourhood of a regular language is regular, so its generating function and
+// bulk matching work as for any other DFA, and no variants of the words are generated.
+class LevenshteinAutomaton {
+public:
+    // DFA over the alphabet accepting the words within distance k of the language of dfa, by the
+    // subset construction over the pairs (state of dfa, number of errors), where only the fewest
+    // errors for every state are kept; for a single word the subsets are the rows of the
+    // Wagner-Fischer table cut at k + 1, for a minimal dictionary automaton the common prefixes
+    // and suffixes of the words are explored once; the default alphabet consists of the letters
+    // of dfa, the result is not minimal and nullptr if it would have more than
+    // maximumNumberOfStates states
+    static DFA* neighbourhood(DFA* dfa, unsigned int k, std::string alphabet = "", unsigned int maximumNumberOfStates = UINT_MAX);
+    static DFA* ofWord(const std::string& word, unsigned int k, const std::string& alphabet = "");
+};
+
+#endif //LEVENSHTEIN_AUTOMATON_H
@@ -0,0 +1,43 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedFile.h"
+#include "InvalidFileException.h"
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw InvalidFileException();
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw InvalidFileException();
+    }
+    this->size = st.st_size;
+    if (this->size > 0) {
+        void* address = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            close(fd);
+            throw InvalidFileException();
+        }
+        this->data = static_cast<const char*>(address);
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (this->data != nullptr) {
+        munmap(const_cast<char*>(this->data), this->size);
+    }
+}
+
+const char* MappedFile::getData() const {
+    return this->data;
+}
+
+std::size_t MappedFile::getSize() const {
+    return this->size;
+}
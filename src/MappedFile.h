@@ -0,0 +1,21 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+private:
+    const char* data = nullptr;
+    std::size_t size = 0;
+public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+    ~MappedFile();
+    const char* getData() const;
+    std::size_t getSize() const;
+};
+
+#endif //MAPPED_FILE_H
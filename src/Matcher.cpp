@@ -0,0 +1,105 @@
+#include "Matcher.h"
+#include "BulkMatcher.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "Statistics.h"
+
+Matcher::Matcher(NFA* _nfa, unsigned int numberOfThreads, unsigned int maximumNumberOfDFAStates) {
+    DFA* _dfa = _nfa->toDFA(numberOfThreads, maximumNumberOfDFAStates);
+    if (_dfa != nullptr) {
+        this->dfa.reset(new CompiledDFA(_dfa->minimize(numberOfThreads)));
+    } else {
+        this->lazy.reset(new LazyDFA(_nfa));
+    }
+}
+
+Matcher::Matcher(DFA* _dfa) {
+    this->dfa.reset(new CompiledDFA(_dfa));
+}
+
+bool Matcher::isDeterministic() const {
+    return this->dfa != nullptr;
+}
+
+const CompiledDFA* Matcher::getCompiledDFA() const {
+    return this->dfa.get();
+}
+
+bool Matcher::regexMatch(const std::string& word) const {
+    return this->dfa != nullptr ? this->dfa->regexMatch(word) : this->lazy->regexMatch(word);
+}
+
+template <bool offsets>
+void Matcher::match(const char* data, std::size_t begin, std::size_t end, unsigned long long& count, std::vector<std::uint64_t>& result) const {
+    std::vector<LazyDFA::Word> buffer;
+    std::size_t position = begin;
+    while (position < end) {
+        std::size_t lineBegin = position;
+        std::size_t lineEnd = position;
+        while (lineEnd < end && data[lineEnd] != '\n') {
+            ++lineEnd;
+        }
+        position = lineEnd + 1;
+        if (lineEnd > lineBegin && data[lineEnd - 1] == '\r') {
+            --lineEnd;
+        }
+        if (this->lazy->regexMatch(data + lineBegin, lineEnd - lineBegin, buffer)) {
+            ++count;
+            if (offsets) {
+                result.push_back(lineBegin);
+            }
+        }
+    }
+}
+
+template <bool offsets>
+void Matcher::match(const char* data, std::size_t size, unsigned int numberOfThreads, unsigned long long& count, std::vector<std::uint64_t>& result) const {
+    STATISTICS_TIMER("lazyMatch");
+    STATISTICS_ADD("lazy_match.bytes", size);
+    std::vector<std::size_t> bounds(numberOfThreads + 1);
+    for (unsigned int t = 0; t <= numberOfThreads; ++t) {
+        bounds[t] = BulkMatcher::getLineBoundary(data, size, size * t / numberOfThreads);
+    }
+    std::vector<unsigned long long> counts(numberOfThreads, 0);
+    std::vector<std::vector<std::uint64_t>> results(numberOfThreads);
+    Parallel::run(numberOfThreads, [&](unsigned int t) {
+        this->match<offsets>(data, bounds[t], bounds[t + 1], counts[t], results[t]);
+    });
+    for (unsigned int t = 0; t < numberOfThreads; ++t) {
+        count += counts[t];
+        if (offsets) {
+            result.insert(result.end(), results[t].begin(), results[t].end());
+        }
+    }
+    STATISTICS_ADD("lazy_match.matches", count);
+}
+
+unsigned long long Matcher::count(const char* data, std::size_t size, unsigned int numberOfThreads) const {
+    if (this->dfa != nullptr) {
+        return BulkMatcher(*this->dfa).count(data, size, numberOfThreads);
+    }
+    unsigned long long result = 0;
+    std::vector<std::uint64_t> unused;
+    this->match<false>(data, size, numberOfThreads, result, unused);
+    return result;
+}
+
+unsigned long long Matcher::countFile(const std::string& path, unsigned int numberOfThreads) const {
+    MappedFile file(path);
+    return this->count(file.getData(), file.getSize(), numberOfThreads);
+}
+
+std::vector<std::uint64_t> Matcher::find(const char* data, std::size_t size, unsigned int numberOfThreads) const {
+    if (this->dfa != nullptr) {
+        return BulkMatcher(*this->dfa).find(data, size, numberOfThreads);
+    }
+    unsigned long long count = 0;
+    std::vector<std::uint64_t> result;
+    this->match<true>(data, size, numberOfThreads, count, result);
+    return result;
+}
+
+std::vector<std::uint64_t> Matcher::findInFile(const std::string& path, unsigned int numberOfThreads) const {
+    MappedFile file(path);
+    return this->find(file.getData(), file.getSize(), numberOfThreads);
+}
@@ -0,0 +1,46 @@
+#ifndef MATCHER_H
+#define MATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "NFA.h"
+#include "DFA.h"
+#include "CompiledDFA.h"
+#include "LazyDFA.h"
+
+// Membership test choosing the representation: a minimized CompiledDFA if the subset
+// construction stays within maximumNumberOfDFAStates states, otherwise a LazyDFA, which
+// builds only the states the words reach and falls back to the BitParallelNFA for words
+// visiting too many of them. Word lists are matched like by BulkMatcher, which is used for
+// the DFA; with the LazyDFA every thread walks the lines of its range without copying them.
+class Matcher {
+public:
+    static const unsigned int DEFAULT_MAXIMUM_NUMBER_OF_DFA_STATES = 1 << 16;
+private:
+    std::unique_ptr<CompiledDFA> dfa;
+    std::unique_ptr<LazyDFA> lazy;
+    template <bool offsets>
+    void match(const char* data, std::size_t begin, std::size_t end, unsigned long long& count, std::vector<std::uint64_t>& result) const;
+    template <bool offsets>
+    void match(const char* data, std::size_t size, unsigned int numberOfThreads, unsigned long long& count, std::vector<std::uint64_t>& result) const;
+public:
+    // nfa has to be ε-free, see NFA::removeEpsilonTransitions
+    explicit Matcher(NFA* nfa, unsigned int numberOfThreads = 1, unsigned int maximumNumberOfDFAStates = DEFAULT_MAXIMUM_NUMBER_OF_DFA_STATES);
+    // an automaton which is already deterministic is always compiled
+    explicit Matcher(DFA* dfa);
+    bool isDeterministic() const;
+    // nullptr if the LazyDFA is used
+    const CompiledDFA* getCompiledDFA() const;
+    bool regexMatch(const std::string& word) const;
+    // number of matching lines of a newline separated word list, see BulkMatcher
+    unsigned long long count(const char* data, std::size_t size, unsigned int numberOfThreads) const;
+    unsigned long long countFile(const std::string& path, unsigned int numberOfThreads) const;
+    // offsets of the first characters of the matching lines, in increasing order
+    std::vector<std::uint64_t> find(const char* data, std::size_t size, unsigned int numberOfThreads) const;
+    std::vector<std::uint64_t> findInFile(const std::string& path, unsigned int numberOfThreads) const;
+};
+
+#endif //MATCHER_H
@@ -2,11 +2,14 @@
 #define MATRIX_INVERSION_H
 
 #include <vector>
+#include "Statistics.h"
 
 template <typename T>
 class MatrixInversion {
 public:
     static std::vector<std::vector<T>> gaussianElimination(std::vector<std::vector<T>> a) {
+        STATISTICS_TIMER("gaussianElimination");
+        STATISTICS_SET("gaussianElimination.size", a.size());
         std::vector<std::vector<T>> b(a.size(), std::vector<T>(a.size(), (T) 0));
         for (int i = 0; i < a.size(); ++i) {
             b[i][i] = (T) 1;
@@ -23,6 +26,7 @@ public:
                 if (a[i][i] != (T) 0) {
                     for (int j = i + 1; j < a.size(); ++j) {
                         if (a[j][i] != (T) 0) {
+                            STATISTICS_ADD("gaussianElimination.row_operations", 1);
                             T t = a[j][i] / a[i][i];
                             for (int k = 0; k < i; ++k) {
                                 b[j][k] -= t * b[i][k];
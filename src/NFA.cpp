@@ -1,8 +1,15 @@
 #include <iostream>
 #include <stack>
 #include <queue>
+#include <atomic>
+#include <algorithm>
+#include <unordered_map>
 #include "NFA.h"
 #include "PtrMap.h"
+#include "Parallel.h"
+#include "ShardedTable.h"
+#include "VectorHash.h"
+#include "Statistics.h"
 
 NFA* NFA::add(NFA* tree) {
     NFA* state = new NFA(false);
@@ -17,6 +24,9 @@ NFA* NFA::add(NFA* tree) {
 NFA* NFA::concatenate(NFA* tree) {
     std::stack<NFA*> states;
     std::stack<NFA*> stateStack;
+    // removed states may still be on the stack through other transitions, so they are deleted
+    // after the search
+    std::vector<NFA*> removedStates;
     NFA* root = this;
     stateStack.push(this);
     if (this != tree) {
@@ -44,7 +54,7 @@ NFA* NFA::concatenate(NFA* tree) {
                     if (state == this) {
                         root = tree;
                     }
-                    delete state;
+                    removedStates.push_back(state);
                 } else {
                     state->acceptable = false;
                     std::set<NFA*> &s = state->transitions['\0'];
@@ -59,11 +69,27 @@ NFA* NFA::concatenate(NFA* tree) {
         states.pop();
         state->explored = false;
     }
+    for (NFA* state : removedStates) {
+        delete state;
+    }
     tree->explored = false;
     return root;
 }
 
 NFA* NFA::cycle() {
+    if (!this->parents.empty()) {
+        // the loop has to return to a state without other incoming transitions, otherwise making
+        // it acceptable would also accept the prefixes leading back to it, e.g. a in (a*b)*
+        NFA* state = new NFA(this->acceptable);
+        for (const auto& p : this->transitions) {
+            std::set<NFA*> &s = state->transitions[p.first];
+            for (NFA* q : p.second) {
+                s.insert(q);
+                q->parents.insert(&s);
+            }
+        }
+        return state->cycle();
+    }
     this->acceptable = false;
     this->concatenate(this);
     this->acceptable = true;
@@ -90,6 +116,18 @@ void NFA::findEpsilonClosures() {
     }
 }
 
+int NFA::getIndex() const {
+    return this->index;
+}
+
+bool NFA::isAcceptable() const {
+    return this->acceptable;
+}
+
+const std::map<char, std::set<NFA*>>& NFA::getTransitions() const {
+    return this->transitions;
+}
+
 unsigned int NFA::getNumberOfStates() {
     std::queue<NFA*> remainingStates;
     remainingStates.push(this);
@@ -115,6 +153,16 @@ unsigned int NFA::getNumberOfStates() {
     return result;
 }
 
+unsigned int NFA::getNumberOfTransitions() {
+    unsigned int result = 0;
+    for (NFA* state : this->getStates()) {
+        for (const auto& p : state->transitions) {
+            result += p.second.size();
+        }
+    }
+    return result;
+}
+
 void NFA::setDepths() {
     std::queue<std::pair<NFA*, int>> remainingStates;
     remainingStates.emplace(this, 0);
@@ -134,6 +182,28 @@ void NFA::setDepths() {
     }
 }
 
+std::vector<NFA*> NFA::getStates() {
+    std::vector<NFA*> states;
+    this->explored = true;
+    this->index = 0;
+    states.push_back(this);
+    for (int i = 0; i < states.size(); ++i) {
+        for (const auto& p : states[i]->transitions) {
+            for (NFA* q : p.second) {
+                if (!q->explored) {
+                    q->explored = true;
+                    q->index = states.size();
+                    states.push_back(q);
+                }
+            }
+        }
+    }
+    for (NFA* state : states) {
+        state->explored = false;
+    }
+    return states;
+}
+
 void NFA::walk(std::string prefix, bool isLast, bool printChildren) {
     std::cout << prefix << (isLast ? "\\" : "|") << "-" << "-(" << (this->acceptable ? "1" : "0") << ")" << this << "\n";
     if (printChildren) {
@@ -180,6 +250,7 @@ NFA::NFA(char transition) {
 }
 
 NFA* NFA::removeEpsilonTransitions() {
+    STATISTICS_TIMER("removeEpsilonTransitions");
     // find the set of all states
     std::list<NFA*> states;
     std::stack<NFA*> stateStack;
@@ -199,31 +270,33 @@ NFA* NFA::removeEpsilonTransitions() {
         }
     }
 
-    // DFS over the graph with epsilon transitions only and set reversed epsilon transitions
+    // DFS over the graph with epsilon transitions only and set reversed epsilon transitions,
+    // states are ordered by the time the search leaves them, as Kosaraju's algorithm requires
     std::stack<NFA*> ordered;
-	std::stack<NFA*> orderedHelp;
+    std::stack<std::pair<NFA*, bool>> searchStack;
     for (NFA* state : states) {
         if (state->explored) {
-            stateStack.push(state);
-            while (!stateStack.empty()) {
-                NFA* q = stateStack.top();
-                stateStack.pop();
-                if (q->explored) {
+            searchStack.emplace(state, false);
+            while (!searchStack.empty()) {
+                NFA* q = searchStack.top().first;
+                bool finished = searchStack.top().second;
+                searchStack.pop();
+                if (finished) {
+                    ordered.push(q);
+                } else if (q->explored) {
                     q->explored = false;
-                    orderedHelp.push(q);
+                    searchStack.emplace(q, true);
                     auto it = q->transitions.find('\0');
                     if (it != q->transitions.end()) {
                         for (NFA* p : it->second) {
-                            stateStack.push(p);
                             p->epsilonParents.push_back(q);
+                            if (p->explored) {
+                                searchStack.emplace(p, false);
+                            }
                         }
                     }
                 }
             }
-			while (!orderedHelp.empty()) {
-				ordered.push(orderedHelp.top());
-				orderedHelp.pop();
-			}
         }
     }
 
@@ -260,13 +333,15 @@ NFA* NFA::removeEpsilonTransitions() {
                 s->insert(groupedState);
                 groupedState->parents.insert(s);
             }
-            for (const auto& p : (*it)->transitions) {
+            for (auto& p : (*it)->transitions) {
                 std::set<NFA*> &s = groupedState->transitions[p.first];
                 for (NFA* r : p.second) {
                     s.insert(r);
+                    r->parents.erase(&p.second);
                     r->parents.insert(&s);
                 }
             }
+            groupedState->acceptable |= (*it)->acceptable;
             delete *it;
         }
         states.push_back(groupedState);
@@ -308,6 +383,185 @@ NFA* NFA::removeEpsilonTransitions() {
         }
     }
 
+    STATISTICS_SET("epsilon_free_nfa.states", this->getNumberOfStates());
+    STATISTICS_SET("epsilon_free_nfa.transitions", this->getNumberOfTransitions());
+    return this;
+}
+
+// the coarsest partition refining block and stable under edges: states stay together only if
+// for every letter their edges lead to the same blocks; returns the number of blocks
+static unsigned int refine(const std::vector<std::vector<std::pair<char, unsigned int>>>& edges, std::vector<unsigned int>& block) {
+    unsigned int n = block.size();
+    unsigned int numberOfBlocks = 0;
+    unsigned int newNumberOfBlocks = std::set<unsigned int>(block.begin(), block.end()).size();
+    std::vector<unsigned long long> signature;
+    while (newNumberOfBlocks != numberOfBlocks) {
+        STATISTICS_ADD("reduce.rounds", 1);
+        numberOfBlocks = newNumberOfBlocks;
+        std::unordered_map<std::vector<unsigned long long>, unsigned int, VectorHash<unsigned long long>> blocks;
+        std::vector<unsigned int> newBlock(n);
+        for (unsigned int i = 0; i < n; ++i) {
+            signature.clear();
+            for (const auto& p : edges[i]) {
+                signature.push_back((unsigned long long) (unsigned char) p.first << 32 | block[p.second]);
+            }
+            std::sort(signature.begin(), signature.end());
+            signature.erase(std::unique(signature.begin(), signature.end()), signature.end());
+            signature.push_back(block[i]);
+            newBlock[i] = blocks.emplace(signature, blocks.size()).first->second;
+        }
+        block = std::move(newBlock);
+        newNumberOfBlocks = blocks.size();
+    }
+    return numberOfBlocks;
+}
+
+NFA* NFA::reduce() {
+    STATISTICS_TIMER("reduce");
+    std::vector<NFA*> states = this->getStates();
+    unsigned int n = states.size();
+    std::vector<std::vector<std::pair<char, unsigned int>>> successors(n), predecessors(n);
+    for (unsigned int i = 0; i < n; ++i) {
+        for (const auto& p : states[i]->transitions) {
+            for (NFA* q : p.second) {
+                successors[i].emplace_back(p.first, q->index);
+                predecessors[q->index].emplace_back(p.first, i);
+            }
+        }
+    }
+
+    // states from which an acceptable state is reachable, the others and the transitions to
+    // them are dropped
+    std::vector<bool> useful(n, false);
+    std::queue<unsigned int> queue;
+    for (unsigned int i = 0; i < n; ++i) {
+        if (states[i]->acceptable) {
+            useful[i] = true;
+            queue.push(i);
+        }
+    }
+    while (!queue.empty()) {
+        unsigned int i = queue.front();
+        queue.pop();
+        for (const auto& p : predecessors[i]) {
+            if (!useful[p.second]) {
+                useful[p.second] = true;
+                queue.push(p.second);
+            }
+        }
+    }
+    // the automaton is kept over indices of the states kept, kept[i] is the index of state i
+    // among all states and representative[j] the index of state j among the kept ones
+    std::vector<int> representative(n, -1);
+    std::vector<unsigned int> kept;
+    for (unsigned int i = 0; i < n; ++i) {
+        if (useful[i] || i == 0) {
+            representative[i] = kept.size();
+            kept.push_back(i);
+        }
+    }
+    std::vector<bool> acceptable;
+    std::vector<std::vector<std::pair<char, unsigned int>>> edges;
+    auto quotient = [&](const std::vector<unsigned int>& block, unsigned int numberOfBlocks) {
+        // the state with the smallest index represents its block, so the initial state stays 0
+        std::vector<int> first(numberOfBlocks, -1);
+        for (unsigned int i = 0; i < block.size(); ++i) {
+            if (first[block[i]] == -1) {
+                first[block[i]] = i;
+            }
+        }
+        std::vector<int> index(numberOfBlocks, -1);
+        std::vector<unsigned int> newKept;
+        for (unsigned int i = 0; i < block.size(); ++i) {
+            if (first[block[i]] == (int) i) {
+                index[block[i]] = newKept.size();
+                newKept.push_back(kept[i]);
+            }
+        }
+        // backward bisimilar states are reached by the same words, so the block is acceptable if
+        // any of its states is
+        std::vector<bool> newAcceptable(numberOfBlocks, false);
+        std::vector<std::vector<std::pair<char, unsigned int>>> newEdges(numberOfBlocks);
+        for (unsigned int i = 0; i < block.size(); ++i) {
+            std::vector<std::pair<char, unsigned int>>& e = newEdges[index[block[i]]];
+            if (acceptable[i]) {
+                newAcceptable[index[block[i]]] = true;
+            }
+            for (const auto& p : edges[i]) {
+                e.emplace_back(p.first, index[block[p.second]]);
+            }
+        }
+        for (auto& e : newEdges) {
+            std::sort(e.begin(), e.end());
+            e.erase(std::unique(e.begin(), e.end()), e.end());
+        }
+        kept = std::move(newKept);
+        acceptable = std::move(newAcceptable);
+        edges = std::move(newEdges);
+    };
+    acceptable.resize(kept.size());
+    edges.resize(kept.size());
+    for (unsigned int i = 0; i < kept.size(); ++i) {
+        acceptable[i] = states[kept[i]]->acceptable;
+        for (const auto& p : successors[kept[i]]) {
+            if (useful[p.second]) {
+                edges[i].emplace_back(p.first, representative[p.second]);
+            }
+        }
+    }
+
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (bool forward : {true, false}) {
+            std::vector<unsigned int> block(kept.size());
+            std::vector<std::vector<std::pair<char, unsigned int>>> reversed;
+            for (unsigned int i = 0; i < kept.size(); ++i) {
+                block[i] = forward ? acceptable[i] : i == 0;
+            }
+            if (!forward) {
+                reversed.resize(kept.size());
+                for (unsigned int i = 0; i < kept.size(); ++i) {
+                    for (const auto& p : edges[i]) {
+                        reversed[p.second].emplace_back(p.first, i);
+                    }
+                }
+            }
+            unsigned int numberOfBlocks = refine(forward ? edges : reversed, block);
+            if (numberOfBlocks < kept.size()) {
+                STATISTICS_ADD(forward ? "reduce.forward_merges" : "reduce.backward_merges", kept.size() - numberOfBlocks);
+                quotient(block, numberOfBlocks);
+                merged = true;
+            }
+        }
+    }
+
+    // the representatives get the transitions of the quotient, the other states are deleted
+    for (unsigned int i = 0; i < kept.size(); ++i) {
+        NFA* state = states[kept[i]];
+        state->acceptable = acceptable[i];
+        state->transitions.clear();
+        state->parents.clear();
+    }
+    for (unsigned int i = 0; i < kept.size(); ++i) {
+        NFA* state = states[kept[i]];
+        for (const auto& p : edges[i]) {
+            std::set<NFA*>& s = state->transitions[p.first];
+            s.insert(states[kept[p.second]]);
+            states[kept[p.second]]->parents.insert(&s);
+        }
+    }
+    std::vector<bool> isKept(n, false);
+    for (unsigned int i : kept) {
+        isKept[i] = true;
+    }
+    for (unsigned int i = 0; i < n; ++i) {
+        if (!isKept[i]) {
+            delete states[i];
+        }
+    }
+    STATISTICS_SET("reduced_nfa.states", kept.size());
+    STATISTICS_SET("reduced_nfa.transitions", this->getNumberOfTransitions());
     return this;
 }
 
@@ -344,6 +598,7 @@ bool NFA::isValidRegex(std::string regex) {
 }
 
 NFA* NFA::regexToAutomaton(std::string regex) {
+    STATISTICS_TIMER("regexToAutomaton");
     if (!isValidRegex(regex)) {
         return nullptr;
     }
@@ -396,10 +651,13 @@ NFA* NFA::regexToAutomaton(std::string regex) {
             ++i;
         }
     }
+    STATISTICS_SET("nfa.states", automaton->getNumberOfStates());
+    STATISTICS_SET("nfa.transitions", automaton->getNumberOfTransitions());
     return automaton;
 }
 
 DFA* NFA::toDFA() {
+    STATISTICS_TIMER("toDFA");
     PtrMap<std::set<NFA*>, DFA> dfaStates;
     std::stack<std::set<NFA*>> stateSetStack;
     std::stack<DFA*> exploredStates;
@@ -434,5 +692,190 @@ DFA* NFA::toDFA() {
         exploredStates.pop();
         state->setExplored(false);
     }
-    return dfaStates[{this}];
+    DFA* result = dfaStates[{this}];
+    STATISTICS_SET("dfa.states", result->getNumberOfStates());
+    STATISTICS_SET("dfa.transitions", result->getNumberOfTransitions());
+    return result;
+}
+
+DFA* NFA::toDFA(unsigned int numberOfThreads, unsigned int maximumNumberOfStates) {
+    STATISTICS_TIMER("toDFA");
+    // subsets are sorted vectors of indices of NFA states
+    std::vector<NFA*> states = this->getStates();
+    ShardedTable<std::vector<int>, VectorHash<int>> subsets(64 * numberOfThreads);
+    struct Subset {
+        unsigned int id;
+        const std::vector<int>* states;
+    };
+    struct ExploredSubset {
+        unsigned int id;
+        bool acceptable;
+        std::vector<std::pair<char, unsigned int>> transitions;
+    };
+    std::vector<Subset> frontier;
+    auto start = subsets.insert({0});
+    frontier.push_back({start.id, start.key});
+    std::vector<bool> acceptable;
+    std::vector<std::vector<std::pair<char, unsigned int>>> transitions;
+
+    // explore the subsets level by level, threads take chunks of the current level
+    while (!frontier.empty()) {
+        STATISTICS_ADD("toDFA.levels", 1);
+        std::vector<std::vector<Subset>> nextFrontiers(numberOfThreads);
+        std::vector<std::vector<ExploredSubset>> explored(numberOfThreads);
+        std::atomic<std::size_t> position(0);
+        Parallel::run(numberOfThreads, [&](unsigned int t) {
+            const std::size_t chunk = 64;
+            std::size_t begin;
+            while ((begin = position.fetch_add(chunk)) < frontier.size() && subsets.size() <= maximumNumberOfStates) {
+                std::size_t end = std::min(frontier.size(), begin + chunk);
+                for (std::size_t i = begin; i < end; ++i) {
+                    ExploredSubset result = {frontier[i].id, false, {}};
+                    std::map<char, std::vector<int>> _transitions;
+                    for (int q : *frontier[i].states) {
+                        result.acceptable |= states[q]->acceptable;
+                        for (const auto& p : states[q]->transitions) {
+                            std::vector<int>& v = _transitions[p.first];
+                            for (NFA* r : p.second) {
+                                v.push_back(r->index);
+                            }
+                        }
+                    }
+                    for (auto& p : _transitions) {
+                        std::sort(p.second.begin(), p.second.end());
+                        p.second.erase(std::unique(p.second.begin(), p.second.end()), p.second.end());
+                        auto entry = subsets.insert(std::move(p.second));
+                        if (entry.inserted) {
+                            nextFrontiers[t].push_back({entry.id, entry.key});
+                        }
+                        result.transitions.emplace_back(p.first, entry.id);
+                    }
+                    explored[t].push_back(std::move(result));
+                }
+            }
+        });
+        if (subsets.size() > maximumNumberOfStates) {
+            STATISTICS_ADD("toDFA.budget_exceeded", 1);
+            return nullptr;
+        }
+        acceptable.resize(subsets.size());
+        transitions.resize(subsets.size());
+        frontier.clear();
+        for (unsigned int t = 0; t < numberOfThreads; ++t) {
+            for (ExploredSubset& result : explored[t]) {
+                acceptable[result.id] = result.acceptable;
+                transitions[result.id] = std::move(result.transitions);
+            }
+            frontier.insert(frontier.end(), nextFrontiers[t].begin(), nextFrontiers[t].end());
+        }
+    }
+
+    // ids depend on the thread interleaving, so states are renumbered by BFS in alphabetical order
+    std::vector<int> canonicalIndex(subsets.size(), -1);
+    std::vector<unsigned int> order;
+    canonicalIndex[start.id] = 0;
+    order.push_back(start.id);
+    for (int i = 0; i < order.size(); ++i) {
+        for (const auto& p : transitions[order[i]]) {
+            if (canonicalIndex[p.second] == -1) {
+                canonicalIndex[p.second] = order.size();
+                order.push_back(p.second);
+            }
+        }
+    }
+    std::vector<DFA*> dfaStates(order.size());
+    for (int i = 0; i < order.size(); ++i) {
+        dfaStates[i] = new DFA();
+        dfaStates[i]->setAcceptable(acceptable[order[i]]);
+    }
+    for (int i = 0; i < order.size(); ++i) {
+        for (const auto& p : transitions[order[i]]) {
+            (*dfaStates[i])[p.first] = dfaStates[canonicalIndex[p.second]];
+        }
+    }
+    STATISTICS_SET("dfa.states", dfaStates.size());
+    STATISTICS_SET("dfa.transitions", dfaStates[0]->getNumberOfTransitions());
+    return dfaStates[0];
+}
+
+std::vector<integer> NFA::countWords(unsigned int maximumLength, unsigned int numberOfThreads) {
+    STATISTICS_TIMER("countWords");
+    typedef std::unordered_map<std::vector<int>, integer, VectorHash<int>> Level;
+    std::vector<NFA*> states = this->getStates();
+    VectorHash<int> hash;
+    // every level is split into shards by the hash of the subset, so that merging the counts
+    // of the next level needs no locks: thread t fills produced[t][shard], then every shard is
+    // merged by one thread
+    const unsigned int numberOfShards = 4 * numberOfThreads;
+    std::vector<Level> level(numberOfShards);
+    level[hash({0}) % numberOfShards].emplace(std::vector<int>({0}), 1);
+    std::vector<integer> result(maximumLength + 1, 0);
+    for (unsigned int length = 0; length <= maximumLength; ++length) {
+        std::size_t size = 0;
+        for (const Level& shard : level) {
+            size += shard.size();
+        }
+        if (size == 0) {
+            break;
+        }
+        STATISTICS_MAX("countWords.max_level_size", size);
+        bool last = length == maximumLength;
+        std::vector<std::vector<Level>> produced(numberOfThreads, std::vector<Level>(last ? 0 : numberOfShards));
+        std::vector<integer> accepted(numberOfThreads, 0);
+        std::atomic<unsigned int> position(0);
+        Parallel::run(numberOfThreads, [&](unsigned int t) {
+            unsigned int s;
+            while ((s = position.fetch_add(1)) < numberOfShards) {
+                for (const auto& entry : level[s]) {
+                    bool acceptable = false;
+                    std::map<char, std::vector<int>> _transitions;
+                    for (int q : entry.first) {
+                        acceptable |= states[q]->acceptable;
+                        if (!last) {
+                            for (const auto& p : states[q]->transitions) {
+                                std::vector<int>& v = _transitions[p.first];
+                                for (NFA* r : p.second) {
+                                    v.push_back(r->index);
+                                }
+                            }
+                        }
+                    }
+                    if (acceptable) {
+                        accepted[t] += entry.second;
+                    }
+                    for (auto& p : _transitions) {
+                        std::sort(p.second.begin(), p.second.end());
+                        p.second.erase(std::unique(p.second.begin(), p.second.end()), p.second.end());
+                        produced[t][hash(p.second) % numberOfShards][std::move(p.second)] += entry.second;
+                    }
+                }
+            }
+        });
+        for (unsigned int t = 0; t < numberOfThreads; ++t) {
+            result[length] += accepted[t];
+        }
+        if (last) {
+            break;
+        }
+        // the current level is not needed any more, only the next one is kept
+        position = 0;
+        Parallel::run(numberOfThreads, [&](unsigned int) {
+            unsigned int s;
+            while ((s = position.fetch_add(1)) < numberOfShards) {
+                Level next;
+                for (unsigned int u = 0; u < numberOfThreads; ++u) {
+                    if (next.empty()) {
+                        next.swap(produced[u][s]);
+                    } else {
+                        for (auto& entry : produced[u][s]) {
+                            next[entry.first] += entry.second;
+                        }
+                        Level().swap(produced[u][s]);
+                    }
+                }
+                level[s].swap(next);
+            }
+        });
+    }
+    return result;
 }
@@ -1,10 +1,12 @@
 #ifndef NFA_H
 #define NFA_H
 
+#include <climits>
 #include <map>
 #include <set>
 #include <list>
 #include <string>
+#include <vector>
 #include "DFA.h"
 
 class NFA {
@@ -26,13 +28,30 @@ public:
     static const bool CONCATENATION;
     explicit NFA(bool acceptable = true);
     explicit NFA(char transition);
+    int getIndex() const;
+    bool isAcceptable() const;
+    const std::map<char, std::set<NFA*>>& getTransitions() const;
+    // states reachable from this one in BFS order, getIndex() of each is set to its position
+    std::vector<NFA*> getStates();
     unsigned int getNumberOfStates();
+    unsigned int getNumberOfTransitions();
     void print();
     NFA* removeEpsilonTransitions();
+    // merges the states of an ε-free NFA that are forward bisimilar (equally acceptable, with
+    // successors in the same classes on every letter) or backward bisimilar (the same for
+    // predecessors, the initial state apart), alternately until neither merges anything, after
+    // removing states from which nothing is accepted; the language does not change and
+    // determinization explores fewer subsets
+    NFA* reduce();
     std::set<NFA*>& operator [] (char transition);
     static bool isValidRegex(std::string regex);
     static NFA* regexToAutomaton(std::string regex);
     DFA* toDFA();
+    // returns nullptr if the DFA would have more than maximumNumberOfStates states
+    DFA* toDFA(unsigned int numberOfThreads, unsigned int maximumNumberOfStates = UINT_MAX);
+    // numbers of accepted words of lengths 0, ..., maximumLength of an ε-free NFA, counted on
+    // the subsets reachable at each length without building the DFA
+    std::vector<integer> countWords(unsigned int maximumLength, unsigned int numberOfThreads = 1);
 };
 
 #endif //NFA_H
\ No newline at end of file
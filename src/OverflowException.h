@@ -0,0 +1,12 @@
+#ifndef OVERFLOW_EXCEPTION_H
+#define OVERFLOW_EXCEPTION_H
+
+#include <exception>
+
+struct OverflowException : public std::exception {
+   const char* what() const noexcept override {
+      return "Error: Number of words does not fit in the chosen integer type.\n";
+   }
+};
+
+#endif //OVERFLOW_EXCEPTION_H
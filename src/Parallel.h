@@ -0,0 +1,28 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <vector>
+
+class Parallel {
+public:
+    static unsigned int getDefaultNumberOfThreads() {
+        unsigned int n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    // calls f(threadIndex) for every threadIndex in [0, numberOfThreads) and waits for all of them
+    template <typename F>
+    static void run(unsigned int numberOfThreads, F f) {
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < numberOfThreads; ++i) {
+            threads.emplace_back(f, i);
+        }
+        f(0);
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+};
+
+#endif //PARALLEL_H
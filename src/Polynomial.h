@@ -4,6 +4,7 @@
 #include <iostream>
 #include <vector>
 #include "ZeroInversionException.h"
+#include "Statistics.h"
 
 template <typename T>
 class Polynomial {
@@ -110,6 +111,15 @@ public:
                 v[i + j] += this->coefficients[i] * a.coefficients[j];
             }
         }
+        STATISTICS_ADD("polynomial.multiplications", 1);
+        STATISTICS_MAX("polynomial.max_degree", m + n - 2);
+        if (STATISTICS_ENABLED) {
+            std::size_t bits = 0;
+            for (const T& c : v) {
+                bits = std::max(bits, Statistics::bitSize(c));
+            }
+            STATISTICS_MAX("polynomial.max_coefficient_bits", bits);
+        }
         return Polynomial(v);
     }
 
@@ -119,6 +129,7 @@ public:
         if (m == 0) {
             throw ZeroInversionException();
         }
+        STATISTICS_ADD("polynomial.divisions", 1);
         std::vector<T> reminder = this->coefficients;
         if (m > n) {
             return {Polynomial(), Polynomial(reminder)};
@@ -240,6 +251,7 @@ public:
     }
 
     static Polynomial gcd(Polynomial a, Polynomial b) {
+        STATISTICS_ADD("polynomial.gcds", 1);
         if (a != Polynomial()) {
             a /= Polynomial({a.coefficients.back()});
         }
@@ -39,11 +39,11 @@ public:
         }
     }
 
-    T getNumerator() {
+    T getNumerator() const {
         return this->numerator;
     }
 
-    T getDenominator() {
+    T getDenominator() const {
         return this->denominator;
     }
 
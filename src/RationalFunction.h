@@ -32,11 +32,11 @@ public:
         setNumeratorAndDenominator(_numerator, _denominator, _reduce);
     }
 
-    Polynomial<T> getNumerator() {
+    Polynomial<T> getNumerator() const {
         return this->numerator;
     }
 
-    Polynomial<T> getDenominator() {
+    Polynomial<T> getDenominator() const {
         return this->denominator;
     }
 
@@ -0,0 +1,614 @@
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include "Regex.h"
+#include "NFA.h"
+#include "Statistics.h"
+
+Regex::Regex(Type _type, char _letter) : type(_type), letter(_letter) {}
+
+Regex::~Regex() {
+    for (Regex* child : this->children) {
+        delete child;
+    }
+}
+
+Regex* Regex::parse(const std::string& regex) {
+    if (!NFA::isValidRegex(regex) || getNestingDepth(regex) > MAXIMUM_DEPTH) {
+        return nullptr;
+    }
+    std::size_t i = 0;
+    int numberOfPositions = 0;
+    return parseUnion(regex, i, numberOfPositions);
+}
+
+unsigned int Regex::getNestingDepth(const std::string& regex) {
+    unsigned int depth = 0, result = 0;
+    for (char c : regex) {
+        if (c == '(') {
+            result = std::max(result, ++depth);
+        } else if (c == ')' && depth > 0) {
+            --depth;
+        }
+    }
+    return result;
+}
+
+Regex* Regex::parseUnion(const std::string& regex, std::size_t& i, int& numberOfPositions) {
+    std::vector<Regex*> terms = {parseConcatenation(regex, i, numberOfPositions)};
+    while (i < regex.size() && regex[i] == '+') {
+        ++i;
+        terms.push_back(parseConcatenation(regex, i, numberOfPositions));
+    }
+    if (terms.size() == 1) {
+        return terms[0];
+    }
+    auto* result = new Regex(UNION);
+    result->children = terms;
+    return result;
+}
+
+Regex* Regex::parseConcatenation(const std::string& regex, std::size_t& i, int& numberOfPositions) {
+    std::vector<Regex*> factors;
+    while (i < regex.size() && regex[i] != '+' && regex[i] != ')') {
+        Regex* factor;
+        if (regex[i] == '(') {
+            ++i;
+            factor = parseUnion(regex, i, numberOfPositions);
+        } else {
+            factor = new Regex(LETTER, regex[i]);
+            factor->position = numberOfPositions++;
+        }
+        ++i;
+        if (i < regex.size() && regex[i] == '*') {
+            // repeated stars and stars of the empty word do not change the language, but they
+            // would make every word ambiguous
+            if (factor->type != STAR && factor->type != EMPTY) {
+                auto* star = new Regex(STAR);
+                star->children.push_back(factor);
+                factor = star;
+            }
+            while (i < regex.size() && regex[i] == '*') {
+                ++i;
+            }
+        }
+        factors.push_back(factor);
+    }
+    if (factors.empty()) {
+        return new Regex(EMPTY);
+    }
+    if (factors.size() == 1) {
+        return factors[0];
+    }
+    auto* result = new Regex(CONCATENATION);
+    result->children = factors;
+    return result;
+}
+
+Regex::Type Regex::getType() const {
+    return this->type;
+}
+
+unsigned int Regex::getSize() const {
+    unsigned int size = 1;
+    for (Regex* child : this->children) {
+        size += child->getSize();
+    }
+    return size;
+}
+
+std::string Regex::toString() const {
+    std::vector<std::string> children;
+    for (Regex* child : this->children) {
+        children.push_back(child->toString());
+    }
+    return format(this->type, this->letter, children, this->children.empty() ? EMPTY : this->children[0]->type);
+}
+
+std::string Regex::format(Type type, char letter, const std::vector<std::string>& children, Type firstChildType) {
+    std::string result;
+    switch (type) {
+        case EMPTY:
+            return "()";
+        case LETTER:
+            return std::string(1, letter);
+        case UNION:
+            result = "(";
+            for (std::size_t i = 0; i < children.size(); ++i) {
+                if (i > 0) {
+                    result += "+";
+                }
+                result += children[i];
+            }
+            return result + ")";
+        case CONCATENATION:
+            for (const std::string& child : children) {
+                result += child;
+            }
+            return result;
+        case STAR:
+            result = children[0];
+            if (firstChildType == CONCATENATION) {
+                result = "(" + result + ")";
+            }
+            return result + "*";
+    }
+    return result;
+}
+
+bool Regex::isNullable() const {
+    switch (this->type) {
+        case EMPTY:
+        case STAR:
+            return true;
+        case LETTER:
+            return false;
+        case UNION:
+            for (Regex* child : this->children) {
+                if (child->isNullable()) {
+                    return true;
+                }
+            }
+            return false;
+        case CONCATENATION:
+            for (Regex* child : this->children) {
+                if (!child->isNullable()) {
+                    return false;
+                }
+            }
+            return true;
+    }
+    return false;
+}
+
+void Regex::numberPositions(int& numberOfPositions) {
+    if (this->type == LETTER) {
+        this->position = numberOfPositions++;
+    }
+    for (Regex* child : this->children) {
+        child->numberPositions(numberOfPositions);
+    }
+}
+
+Regex* Regex::simplify(Regex* regex) {
+    STATISTICS_TIMER("simplify");
+    STATISTICS_SET("simplify.nodes_before", regex->getSize());
+    int numberOfPositions = 0;
+    regex->numberPositions(numberOfPositions);
+    STATISTICS_SET("simplify.positions_before", numberOfPositions);
+    regex = simplifyNode(regex);
+    // positions of the Glushkov automaton are numbered again, letters may have been removed
+    numberOfPositions = 0;
+    regex->numberPositions(numberOfPositions);
+    STATISTICS_SET("simplify.nodes_after", regex->getSize());
+    STATISTICS_SET("simplify.positions_after", numberOfPositions);
+    return regex;
+}
+
+Regex* Regex::simplifyNode(Regex* regex) {
+    for (Regex*& child : regex->children) {
+        child = simplifyNode(child);
+    }
+    if (regex->type == UNION) {
+        return simplifyUnion(regex);
+    }
+    if (regex->type == CONCATENATION) {
+        std::vector<Regex*> factors;
+        for (Regex* child : regex->children) {
+            if (child->type == CONCATENATION) {
+                factors.insert(factors.end(), child->children.begin(), child->children.end());
+                child->children.clear();
+                delete child;
+            } else if (child->type == EMPTY) {
+                delete child;
+            } else if (child->type == STAR && !factors.empty() && factors.back()->type == STAR
+                       && child->toString() == factors.back()->toString()) {
+                // X*X* = X*
+                delete child;
+            } else {
+                factors.push_back(child);
+            }
+        }
+        regex->children.clear();
+        if (factors.size() <= 1) {
+            delete regex;
+            return factors.empty() ? new Regex(EMPTY) : factors[0];
+        }
+        regex->children = factors;
+        return regex;
+    }
+    if (regex->type == STAR) {
+        Regex* body = simplifyStarBody(regex->children[0]);
+        if (body->type == STAR || body->type == EMPTY) {
+            regex->children.clear();
+            delete regex;
+            return body;
+        }
+        regex->children[0] = body;
+    }
+    return regex;
+}
+
+Regex* Regex::simplifyUnion(Regex* regex) {
+    // flattening, then removal of repeated terms and of terms X next to X*
+    std::vector<Regex*> terms;
+    for (Regex* child : regex->children) {
+        if (child->type == UNION) {
+            terms.insert(terms.end(), child->children.begin(), child->children.end());
+            child->children.clear();
+            delete child;
+        } else {
+            terms.push_back(child);
+        }
+    }
+    regex->children.clear();
+    std::vector<std::string> keys;
+    std::vector<std::string> starred;
+    for (Regex* term : terms) {
+        keys.push_back(term->toString());
+        if (term->type == STAR) {
+            starred.push_back(term->children[0]->toString());
+        }
+    }
+    bool hasNullableTerm = false;
+    for (Regex* term : terms) {
+        hasNullableTerm |= term->type != EMPTY && term->isNullable();
+    }
+    std::vector<Regex*> kept;
+    std::vector<std::string> keptKeys;
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        if (std::find(keptKeys.begin(), keptKeys.end(), keys[i]) != keptKeys.end()
+            || std::find(starred.begin(), starred.end(), keys[i]) != starred.end()
+            || (terms[i]->type == EMPTY && hasNullableTerm)) {
+            delete terms[i];
+        } else {
+            kept.push_back(terms[i]);
+            keptKeys.push_back(keys[i]);
+        }
+    }
+
+    // terms with equal first factors, in the order of their first occurrence, are factored:
+    // XY + XZ = X(Y + Z)
+    std::vector<std::string> firstKeys;
+    for (Regex* term : kept) {
+        firstKeys.push_back(term->type == CONCATENATION ? term->children[0]->toString() : term->toString());
+    }
+    std::vector<Regex*> result;
+    std::vector<bool> used(kept.size(), false);
+    for (std::size_t i = 0; i < kept.size(); ++i) {
+        if (used[i]) {
+            continue;
+        }
+        std::vector<std::size_t> group;
+        for (std::size_t j = i; j < kept.size(); ++j) {
+            if (!used[j] && firstKeys[j] == firstKeys[i]) {
+                group.push_back(j);
+                used[j] = true;
+            }
+        }
+        if (group.size() == 1) {
+            result.push_back(kept[i]);
+            continue;
+        }
+        Regex* first = nullptr;
+        auto* rests = new Regex(UNION);
+        for (std::size_t j : group) {
+            Regex* term = kept[j];
+            Regex* rest;
+            if (term->type == CONCATENATION) {
+                Regex* head = term->children[0];
+                term->children.erase(term->children.begin());
+                if (first == nullptr) {
+                    first = head;
+                } else {
+                    delete head;
+                }
+                if (term->children.size() == 1) {
+                    rest = term->children[0];
+                    term->children.clear();
+                    delete term;
+                } else {
+                    rest = term;
+                }
+            } else {
+                if (first == nullptr) {
+                    first = term;
+                } else {
+                    delete term;
+                }
+                rest = new Regex(EMPTY);
+            }
+            rests->children.push_back(rest);
+        }
+        auto* factored = new Regex(CONCATENATION);
+        factored->children = {first, simplifyUnion(rests)};
+        result.push_back(simplifyNode(factored));
+    }
+    if (result.size() == 1) {
+        delete regex;
+        return result[0];
+    }
+    regex->children = result;
+    return regex;
+}
+
+Regex* Regex::simplifyStarBody(Regex* body) {
+    // inside a star: (X*)* = X*, (() + X)* = X*, (X* + Y)* = (X + Y)* and, if every factor is
+    // nullable, (XY)* = (X + Y)*; nested unions are flattened first, so that their terms are
+    // rewritten too
+    while (true) {
+        if (body->type == STAR) {
+            Regex* inner = body->children[0];
+            body->children.clear();
+            delete body;
+            body = inner;
+        } else if (body->type == CONCATENATION && body->isNullable()) {
+            body->type = UNION;
+        } else if (body->type == UNION) {
+            bool changed = false;
+            std::vector<Regex*> terms;
+            for (Regex* term : body->children) {
+                if (term->type == EMPTY) {
+                    delete term;
+                    changed = true;
+                } else if (term->type == UNION) {
+                    terms.insert(terms.end(), term->children.begin(), term->children.end());
+                    term->children.clear();
+                    delete term;
+                    changed = true;
+                } else if (term->type == STAR) {
+                    terms.push_back(term->children[0]);
+                    term->children.clear();
+                    delete term;
+                    changed = true;
+                } else if (term->type == CONCATENATION && term->isNullable()) {
+                    // X + YZ with nullable Y and Z generates the same star as X + Y + Z
+                    terms.insert(terms.end(), term->children.begin(), term->children.end());
+                    term->children.clear();
+                    delete term;
+                    changed = true;
+                } else {
+                    terms.push_back(term);
+                }
+            }
+            body->children = terms;
+            if (!changed) {
+                return body;
+            }
+            if (terms.empty()) {
+                body->children.clear();
+                delete body;
+                return new Regex(EMPTY);
+            }
+            body = simplifyUnion(body);
+        } else {
+            return body;
+        }
+    }
+}
+
+char Regex::getLetter() const {
+    return this->letter;
+}
+
+const std::vector<Regex*>& Regex::getChildren() const {
+    return this->children;
+}
+
+bool Regex::hasAmbiguousEmptyWord(unsigned int& numberOfEmptyParses) const {
+    switch (this->type) {
+        case EMPTY:
+            numberOfEmptyParses = 1;
+            return false;
+        case LETTER:
+            numberOfEmptyParses = 0;
+            return false;
+        case UNION:
+        case CONCATENATION:
+            numberOfEmptyParses = this->type == CONCATENATION;
+            for (Regex* child : this->children) {
+                unsigned int childParses;
+                if (child->hasAmbiguousEmptyWord(childParses)) {
+                    return true;
+                }
+                numberOfEmptyParses = this->type == UNION ? numberOfEmptyParses + childParses : numberOfEmptyParses * childParses;
+            }
+            return numberOfEmptyParses > 1;
+        case STAR:
+            // a nullable body can be repeated any number of times without reading anything
+            if (this->children[0]->hasAmbiguousEmptyWord(numberOfEmptyParses) || numberOfEmptyParses > 0) {
+                return true;
+            }
+            numberOfEmptyParses = 1;
+            return false;
+    }
+    return false;
+}
+
+void Regex::glushkov(bool& nullable, std::vector<int>& first, std::vector<int>& last, std::vector<std::vector<int>>& follow, std::vector<char>& letters) const {
+    // state 0 of the Glushkov automaton is the initial one, state p + 1 is the letter at position p
+    first.clear();
+    last.clear();
+    switch (this->type) {
+        case EMPTY:
+            nullable = true;
+            break;
+        case LETTER:
+            nullable = false;
+            if (letters.size() <= (std::size_t) this->position + 1) {
+                letters.resize(this->position + 2);
+                follow.resize(this->position + 2);
+            }
+            letters[this->position + 1] = this->letter;
+            first.push_back(this->position + 1);
+            last.push_back(this->position + 1);
+            break;
+        case UNION:
+            nullable = false;
+            for (Regex* child : this->children) {
+                bool childNullable;
+                std::vector<int> childFirst, childLast;
+                child->glushkov(childNullable, childFirst, childLast, follow, letters);
+                nullable |= childNullable;
+                first.insert(first.end(), childFirst.begin(), childFirst.end());
+                last.insert(last.end(), childLast.begin(), childLast.end());
+            }
+            break;
+        case CONCATENATION:
+            nullable = true;
+            for (Regex* child : this->children) {
+                bool childNullable;
+                std::vector<int> childFirst, childLast;
+                child->glushkov(childNullable, childFirst, childLast, follow, letters);
+                for (int p : last) {
+                    follow[p].insert(follow[p].end(), childFirst.begin(), childFirst.end());
+                }
+                if (nullable) {
+                    first.insert(first.end(), childFirst.begin(), childFirst.end());
+                }
+                if (!childNullable) {
+                    last.clear();
+                }
+                last.insert(last.end(), childLast.begin(), childLast.end());
+                nullable &= childNullable;
+            }
+            break;
+        case STAR:
+            this->children[0]->glushkov(nullable, first, last, follow, letters);
+            for (int p : last) {
+                follow[p].insert(follow[p].end(), first.begin(), first.end());
+            }
+            nullable = true;
+            break;
+    }
+}
+
+bool Regex::isUnambiguous() const {
+    STATISTICS_TIMER("isUnambiguous");
+    unsigned int numberOfEmptyParses;
+    if (this->hasAmbiguousEmptyWord(numberOfEmptyParses)) {
+        return false;
+    }
+    bool nullable;
+    std::vector<int> first, last;
+    std::vector<std::vector<int>> follow(1);
+    std::vector<char> letters(1);
+    this->glushkov(nullable, first, last, follow, letters);
+    follow[0] = first;
+    std::size_t numberOfStates = letters.size();
+    std::vector<bool> acceptable(numberOfStates, false);
+    acceptable[0] = nullable;
+    for (int p : last) {
+        acceptable[p] = true;
+    }
+    // successors sorted by letter, so that pairs of transitions on the same letter are adjacent
+    for (std::vector<int>& successors : follow) {
+        std::sort(successors.begin(), successors.end(), [&letters](int p, int q) {
+            return letters[p] < letters[q] || (letters[p] == letters[q] && p < q);
+        });
+        successors.erase(std::unique(successors.begin(), successors.end()), successors.end());
+    }
+
+    // the automaton is ambiguous iff a pair of different states is reachable from (0, 0) in its
+    // square and leads to a pair of accepting states; the square is symmetric, so p <= q
+    std::unordered_map<unsigned long long, unsigned int> indices;
+    std::vector<std::pair<int, int>> pairs;
+    std::vector<std::vector<unsigned int>> predecessors;
+    std::queue<unsigned int> queue;
+    auto visit = [&](int p, int q, int from) {
+        if (p > q) {
+            std::swap(p, q);
+        }
+        auto inserted = indices.emplace((unsigned long long) p * numberOfStates + q, pairs.size());
+        if (inserted.second) {
+            pairs.emplace_back(p, q);
+            predecessors.emplace_back();
+            queue.push(inserted.first->second);
+        }
+        if (from >= 0) {
+            predecessors[inserted.first->second].push_back(from);
+        }
+    };
+    visit(0, 0, -1);
+    while (!queue.empty()) {
+        unsigned int index = queue.front();
+        queue.pop();
+        const std::vector<int>& a = follow[pairs[index].first];
+        const std::vector<int>& b = follow[pairs[index].second];
+        std::size_t i = 0, j = 0;
+        while (i < a.size() && j < b.size()) {
+            if (letters[a[i]] < letters[b[j]]) {
+                ++i;
+            } else if (letters[a[i]] > letters[b[j]]) {
+                ++j;
+            } else {
+                char c = letters[a[i]];
+                std::size_t k = j;
+                for (; i < a.size() && letters[a[i]] == c; ++i) {
+                    for (k = j; k < b.size() && letters[b[k]] == c; ++k) {
+                        visit(a[i], b[k], index);
+                    }
+                }
+                j = k;
+            }
+        }
+    }
+    STATISTICS_SET("glushkov.positions", numberOfStates - 1);
+    STATISTICS_SET("glushkov.pairs", pairs.size());
+
+    std::vector<bool> useful(pairs.size(), false);
+    for (unsigned int index = 0; index < pairs.size(); ++index) {
+        if (acceptable[pairs[index].first] && acceptable[pairs[index].second]) {
+            useful[index] = true;
+            queue.push(index);
+        }
+    }
+    while (!queue.empty()) {
+        unsigned int index = queue.front();
+        queue.pop();
+        if (pairs[index].first != pairs[index].second) {
+            return false;
+        }
+        for (unsigned int predecessor : predecessors[index]) {
+            if (!useful[predecessor]) {
+                useful[predecessor] = true;
+                queue.push(predecessor);
+            }
+        }
+    }
+    return true;
+}
+
+RationalFunction<Rational<integer>> Regex::getGeneratingFunction() const {
+    std::vector<RationalFunction<Rational<integer>>> children;
+    for (Regex* child : this->children) {
+        children.push_back(child->getGeneratingFunction());
+    }
+    return combine(this->type, children);
+}
+
+RationalFunction<Rational<integer>> Regex::combine(Type type, const std::vector<RationalFunction<Rational<integer>>>& children) {
+    typedef Rational<integer> Number;
+    typedef RationalFunction<Number> Function;
+    switch (type) {
+        case EMPTY:
+            return Function(1);
+        case LETTER:
+            return Function(std::vector<Number>({Number(0), Number(1)}));
+        case UNION:
+        case CONCATENATION: {
+            Function result = children[0];
+            for (std::size_t i = 1; i < children.size(); ++i) {
+                if (type == UNION) {
+                    result += children[i];
+                } else {
+                    result *= children[i];
+                }
+            }
+            return result;
+        }
+        case STAR:
+            return Function(1) / (Function(1) - children[0]);
+    }
+    return Function();
+}
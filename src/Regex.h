@@ -0,0 +1,69 @@
+#ifndef REGEX_H
+#define REGEX_H
+
+#include <string>
+#include <vector>
+#include "DFA.h"
+#include "RationalFunction.h"
+
+// Syntax tree of a regular expression in the syntax of NFA::regexToAutomaton. If every word
+// of the language has exactly one parse, the generating function follows from the symbolic
+// method: union is a sum, concatenation a product and star 1 / (1 - f), so neither a DFA nor
+// the elimination over its states is needed.
+class Regex {
+public:
+    enum Type { EMPTY, LETTER, UNION, CONCATENATION, STAR };
+    // the algorithms on the tree are recursive, so expressions with parentheses nested deeper
+    // are not parsed; the automaton pipeline handles them
+    static const unsigned int MAXIMUM_DEPTH = 1000;
+private:
+    Type type;
+    char letter = '\0';
+    // index of the letter among all letters of the expression, used by the Glushkov automaton
+    int position = -1;
+    std::vector<Regex*> children;
+    Regex(Type type, char letter = '\0');
+    static Regex* parseUnion(const std::string& regex, std::size_t& i, int& numberOfPositions);
+    static Regex* parseConcatenation(const std::string& regex, std::size_t& i, int& numberOfPositions);
+    bool hasAmbiguousEmptyWord(unsigned int& numberOfEmptyParses) const;
+    bool isNullable() const;
+    void numberPositions(int& numberOfPositions);
+    static Regex* simplifyNode(Regex* regex);
+    static Regex* simplifyUnion(Regex* regex);
+    static Regex* simplifyStarBody(Regex* body);
+    void glushkov(bool& nullable, std::vector<int>& first, std::vector<int>& last, std::vector<std::vector<int>>& follow, std::vector<char>& letters) const;
+public:
+    Regex(const Regex&) = delete;
+    Regex& operator = (const Regex&) = delete;
+    ~Regex();
+    // nullptr if the expression is not valid or nested deeper than MAXIMUM_DEPTH
+    static Regex* parse(const std::string& regex);
+    // the maximum number of open parentheses
+    static unsigned int getNestingDepth(const std::string& regex);
+    // rewrites the expression, which is taken over, into an equivalent one with fewer letters
+    // and usually fewer nodes, so that the automata built from it are smaller:
+    // nested unions and concatenations are flattened, repeated terms of a union removed,
+    // common first factors of terms factored out, and stars absorbed ((X*)* = X*,
+    // (X*Y*)* = (X+Y)*, X*X* = X*); a single bottom-up pass, so the cost is bounded by the
+    // size times the depth of the expression
+    static Regex* simplify(Regex* regex);
+    Type getType() const;
+    char getLetter() const;
+    const std::vector<Regex*>& getChildren() const;
+    // the number of nodes
+    unsigned int getSize() const;
+    // the expression in the syntax of NFA::regexToAutomaton
+    std::string toString() const;
+    // true if no word has two parses, checked on the Glushkov automaton, which is unambiguous
+    // exactly when the expression is, together with the parses of the empty word
+    bool isUnambiguous() const;
+    // the generating function of the numbers of parses, equal to the numbers of words if the
+    // expression is unambiguous
+    RationalFunction<Rational<integer>> getGeneratingFunction() const;
+    // toString and getGeneratingFunction of a node given the results of its children, shared
+    // with RegexDag; firstChildType decides if the body of a star needs parentheses
+    static std::string format(Type type, char letter, const std::vector<std::string>& children, Type firstChildType);
+    static RationalFunction<Rational<integer>> combine(Type type, const std::vector<RationalFunction<Rational<integer>>>& children);
+};
+
+#endif //REGEX_H
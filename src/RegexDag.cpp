@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <unordered_set>
+#include "RegexDag.h"
+#include "Statistics.h"
+
+RegexDag::RegexDag(unsigned int _numberOfThreads) : numberOfThreads(_numberOfThreads) {}
+
+RegexDag::~RegexDag() {
+    for (Node& node : this->nodes) {
+        if (node.automaton == nullptr) {
+            continue;
+        }
+        std::unordered_set<DFA*> states = {node.automaton};
+        std::queue<DFA*> queue;
+        queue.push(node.automaton);
+        while (!queue.empty()) {
+            DFA* state = queue.front();
+            queue.pop();
+            for (const auto& p : state->getTransitions()) {
+                if (states.insert(p.second).second) {
+                    queue.push(p.second);
+                }
+            }
+        }
+        for (DFA* state : states) {
+            delete state;
+        }
+    }
+}
+
+unsigned int RegexDag::intern(const Regex* regex) {
+    std::vector<unsigned int> children;
+    for (const Regex* child : regex->getChildren()) {
+        children.push_back(this->intern(child));
+    }
+    std::string key;
+    key.push_back((char) regex->getType());
+    key.push_back(regex->getLetter());
+    key.append(reinterpret_cast<const char*>(children.data()), children.size() * sizeof(unsigned int));
+    auto inserted = this->indices.emplace(key, this->nodes.size());
+    if (inserted.second) {
+        this->nodes.emplace_back();
+        Node& node = this->nodes.back();
+        node.type = regex->getType();
+        node.letter = regex->getLetter();
+        node.children = std::move(children);
+    } else {
+        STATISTICS_ADD("regexDag.shared", 1);
+    }
+    return inserted.first->second;
+}
+
+int RegexDag::add(const std::string& regex) {
+    Regex* tree = Regex::parse(regex);
+    if (tree == nullptr) {
+        return -1;
+    }
+    unsigned int node = this->intern(tree);
+    delete tree;
+    STATISTICS_SET("regexDag.nodes", this->nodes.size());
+    return node;
+}
+
+unsigned int RegexDag::getNumberOfNodes() const {
+    return this->nodes.size();
+}
+
+std::string RegexDag::toString(unsigned int node) const {
+    const Node& n = this->nodes[node];
+    std::vector<std::string> children;
+    for (unsigned int child : n.children) {
+        children.push_back(this->toString(child));
+    }
+    return Regex::format(n.type, n.letter, children, n.children.empty() ? Regex::EMPTY : this->nodes[n.children[0]].type);
+}
+
+DFA* RegexDag::getAutomaton(unsigned int node) {
+    if (this->nodes[node].automaton == nullptr) {
+        this->nodes[node].automaton = this->build(node);
+    }
+    return this->nodes[node].automaton;
+}
+
+DFA* RegexDag::build(unsigned int node) {
+    STATISTICS_TIMER("regexDag.build");
+    STATISTICS_ADD("regexDag.automata", 1);
+    Regex::Type type = this->nodes[node].type;
+    if (type == Regex::EMPTY || type == Regex::LETTER) {
+        auto* start = new DFA();
+        if (type == Regex::EMPTY) {
+            start->setAcceptable(true);
+        } else {
+            auto* end = new DFA();
+            end->setAcceptable(true);
+            (*start)[this->nodes[node].letter] = end;
+        }
+        return start;
+    }
+    std::vector<DFA*> automata;
+    for (unsigned int child : this->nodes[node].children) {
+        automata.push_back(this->getAutomaton(child));
+    }
+
+    // subset construction over the pairs (child, state of its automaton); in a concatenation an
+    // accepting state of a child also starts the next one, in a star it starts the body again,
+    // and the pair (1, nullptr) marks the initial subset of a star, which accepts the empty word
+    typedef std::vector<std::pair<unsigned int, DFA*>> Subset;
+    auto close = [&](Subset& subset) {
+        for (std::size_t i = 0; i < subset.size(); ++i) {
+            DFA* state = subset[i].second;
+            if (state == nullptr || !state->isAcceptable()) {
+                continue;
+            }
+            std::pair<unsigned int, DFA*> next(0, automata[0]);
+            if (type == Regex::CONCATENATION && subset[i].first + 1 < automata.size()) {
+                next = {subset[i].first + 1, automata[subset[i].first + 1]};
+            } else if (type != Regex::STAR) {
+                continue;
+            }
+            if (std::find(subset.begin(), subset.end(), next) == subset.end()) {
+                subset.push_back(next);
+            }
+        }
+        std::sort(subset.begin(), subset.end());
+        subset.erase(std::unique(subset.begin(), subset.end()), subset.end());
+    };
+    auto isAcceptable = [&](const Subset& subset) {
+        for (const auto& p : subset) {
+            if (p.second == nullptr || (p.second->isAcceptable() && (type != Regex::CONCATENATION || p.first + 1 == automata.size()))) {
+                return true;
+            }
+        }
+        return false;
+    };
+    std::map<Subset, DFA*> subsets;
+    std::queue<const Subset*> frontier;
+    auto getState = [&](Subset&& subset) {
+        auto inserted = subsets.emplace(std::move(subset), nullptr);
+        if (inserted.second) {
+            inserted.first->second = new DFA();
+            inserted.first->second->setAcceptable(isAcceptable(inserted.first->first));
+            frontier.push(&inserted.first->first);
+        }
+        return inserted.first->second;
+    };
+    Subset initial;
+    if (type == Regex::UNION) {
+        for (unsigned int i = 0; i < automata.size(); ++i) {
+            initial.emplace_back(i, automata[i]);
+        }
+    } else {
+        initial.emplace_back(0, automata[0]);
+        if (type == Regex::STAR) {
+            initial.emplace_back(1, nullptr);
+        }
+    }
+    close(initial);
+    DFA* start = getState(std::move(initial));
+    while (!frontier.empty()) {
+        const Subset& subset = *frontier.front();
+        frontier.pop();
+        DFA* state = subsets.at(subset);
+        std::map<char, Subset> successors;
+        for (const auto& p : subset) {
+            if (p.second != nullptr) {
+                for (const auto& q : p.second->getTransitions()) {
+                    successors[q.first].emplace_back(p.first, q.second);
+                }
+            }
+        }
+        for (auto& p : successors) {
+            close(p.second);
+            (*state)[p.first] = getState(std::move(p.second));
+        }
+    }
+    return start->minimize(this->numberOfThreads);
+}
+
+bool RegexDag::isUnambiguous(unsigned int node) {
+    if (this->nodes[node].unambiguous < 0) {
+        Regex* tree = Regex::parse(this->toString(node));
+        this->nodes[node].unambiguous = tree->isUnambiguous();
+        delete tree;
+    }
+    return this->nodes[node].unambiguous;
+}
+
+RegexDag::Function RegexDag::getGeneratingFunction(unsigned int node) {
+    if (this->nodes[node].hasGeneratingFunction) {
+        STATISTICS_ADD("regexDag.functionHits", 1);
+        return this->nodes[node].generatingFunction;
+    }
+    Function result;
+    // the subexpressions of an unambiguous expression are unambiguous, so they are not checked
+    if (this->isUnambiguous(node)) {
+        const Node& n = this->nodes[node];
+        for (unsigned int child : n.children) {
+            this->nodes[child].unambiguous = 1;
+        }
+        std::vector<Function> children;
+        for (unsigned int child : n.children) {
+            children.push_back(this->getGeneratingFunction(child));
+        }
+        result = Regex::combine(n.type, children);
+    } else {
+        result = this->getAutomaton(node)->getGeneratingFunction();
+    }
+    this->nodes[node].generatingFunction = result;
+    this->nodes[node].hasGeneratingFunction = true;
+    return result;
+}
@@ -0,0 +1,54 @@
+#ifndef REGEX_DAG_H
+#define REGEX_DAG_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DFA.h"
+#include "Regex.h"
+#include "RationalFunction.h"
+
+// Regular expressions hash-consed into a DAG: equal subexpressions, within one expression or
+// across a batch of them, are a single node, and every node memoizes its minimal automaton,
+// built from the automata of its children, and its generating function. After a change of one
+// clause of an expression only the nodes on the path from the clause to the root are new, so
+// only they are computed.
+class RegexDag {
+public:
+    typedef RationalFunction<Rational<integer>> Function;
+private:
+    struct Node {
+        Regex::Type type;
+        char letter;
+        std::vector<unsigned int> children;
+        DFA* automaton = nullptr;
+        // -1 until checked
+        int unambiguous = -1;
+        bool hasGeneratingFunction = false;
+        Function generatingFunction;
+    };
+    std::vector<Node> nodes;
+    // type, letter and children of every node
+    std::unordered_map<std::string, unsigned int> indices;
+    unsigned int numberOfThreads;
+    unsigned int intern(const Regex* regex);
+    DFA* build(unsigned int node);
+public:
+    explicit RegexDag(unsigned int numberOfThreads = 1);
+    RegexDag(const RegexDag&) = delete;
+    RegexDag& operator = (const RegexDag&) = delete;
+    ~RegexDag();
+    // the node of the expression, -1 if it is not valid or nested deeper than Regex::MAXIMUM_DEPTH
+    int add(const std::string& regex);
+    unsigned int getNumberOfNodes() const;
+    // the expression of the node in the syntax of NFA::regexToAutomaton
+    std::string toString(unsigned int node) const;
+    // the minimal automaton, owned by the DAG
+    DFA* getAutomaton(unsigned int node);
+    bool isUnambiguous(unsigned int node);
+    // composed from the functions of the children by the symbolic method if the node is
+    // unambiguous, otherwise computed from the automaton
+    Function getGeneratingFunction(unsigned int node);
+};
+
+#endif //REGEX_DAG_H
@@ -0,0 +1,49 @@
+#ifndef SHARDED_TABLE_H
+#define SHARDED_TABLE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Hash table assigning consecutive ids to keys, safe for concurrent insertion. Keys are split
+// into independently locked shards by their hash. Stored keys never move, so pointers to them
+// stay valid for the lifetime of the table.
+template <typename K, typename Hash = std::hash<K>>
+class ShardedTable {
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<K, unsigned int, Hash> map;
+    };
+    std::unique_ptr<Shard[]> shards;
+    unsigned int numberOfShards;
+    std::atomic<unsigned int> counter;
+    Hash hash;
+public:
+    struct Entry {
+        unsigned int id;
+        const K* key;
+        bool inserted;
+    };
+
+    explicit ShardedTable(unsigned int _numberOfShards) : shards(new Shard[_numberOfShards]), numberOfShards(_numberOfShards), counter(0) {}
+
+    Entry insert(K key) {
+        Shard& shard = this->shards[this->hash(key) % this->numberOfShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) {
+            return {it->second, &it->first, false};
+        }
+        it = shard.map.emplace(std::move(key), this->counter++).first;
+        return {it->second, &it->first, true};
+    }
+
+    unsigned int size() const {
+        return this->counter;
+    }
+};
+
+#endif //SHARDED_TABLE_H
@@ -0,0 +1,58 @@
+#include <iomanip>
+#include <tuple>
+#include "Statistics.h"
+
+std::mutex Statistics::mutex;
+
+std::map<std::string, Statistics::Counter>& Statistics::getCounters() {
+    static std::map<std::string, Counter> counters;
+    return counters;
+}
+
+Statistics::Counter& Statistics::getCounter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(Statistics::mutex);
+    return getCounters().emplace(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple(0)).first->second;
+}
+
+void Statistics::updateGmpCounters() {
+    if (GmpAllocator::isInstalled()) {
+        getCounter("gmp.allocations") = GmpAllocator::getAllocations();
+        getCounter("gmp.reallocations") = GmpAllocator::getReallocations();
+        getCounter("gmp.frees") = GmpAllocator::getFrees();
+        getCounter("gmp.allocated_bytes") = GmpAllocator::getAllocatedBytes();
+        getCounter("gmp.current_bytes") = GmpAllocator::getCurrentBytes();
+        getCounter("gmp.peak_bytes") = GmpAllocator::getPeakBytes();
+    }
+}
+
+void Statistics::reset() {
+    std::lock_guard<std::mutex> lock(Statistics::mutex);
+    for (auto& p : getCounters()) {
+        p.second = 0;
+    }
+}
+
+void Statistics::print(std::ostream& s) {
+    updateGmpCounters();
+    std::lock_guard<std::mutex> lock(Statistics::mutex);
+    for (const auto& p : getCounters()) {
+        const std::string& name = p.first;
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, ".ns") == 0) {
+            s << name.substr(0, name.size() - 3) << ".ms: " << std::fixed << std::setprecision(3) << p.second / 1e6 << std::defaultfloat << "\n";
+        } else {
+            s << name << ": " << p.second << "\n";
+        }
+    }
+}
+
+void Statistics::printJson(std::ostream& s) {
+    updateGmpCounters();
+    std::lock_guard<std::mutex> lock(Statistics::mutex);
+    s << "{";
+    bool first = true;
+    for (const auto& p : getCounters()) {
+        s << (first ? "" : ", ") << "\"" << p.first << "\": " << p.second;
+        first = false;
+    }
+    s << "}";
+}
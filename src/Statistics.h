@@ -0,0 +1,106 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <gmpxx.h>
+#include "Rational.h"
+#include "GmpAllocator.h"
+
+// Process-wide counters filled by the STATISTICS_* macros. Without CFL_STATISTICS the macros
+// expand to nothing and their arguments are not evaluated, so the instrumentation is free.
+class Statistics {
+public:
+    typedef std::atomic<unsigned long long> Counter;
+
+    // measures the time of a stage and, if GmpAllocator is installed, the GMP allocations made by
+    // the calling thread during the stage
+    class Timer {
+    private:
+        const char* name;
+        Counter& nanoseconds;
+        Counter& calls;
+        std::chrono::steady_clock::time_point begin;
+        unsigned long long gmpAllocations;
+        unsigned long long gmpBytes;
+    public:
+        Timer(const char* _name, Counter& _nanoseconds, Counter& _calls) : name(_name), nanoseconds(_nanoseconds), calls(_calls),
+            begin(std::chrono::steady_clock::now()), gmpAllocations(GmpAllocator::getThreadAllocations()), gmpBytes(GmpAllocator::getThreadAllocatedBytes()) {}
+
+        ~Timer() {
+            this->nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->begin).count();
+            ++this->calls;
+            if (GmpAllocator::isInstalled()) {
+                Statistics::getCounter(std::string("memory.") + this->name + ".gmp_allocations") += GmpAllocator::getThreadAllocations() - this->gmpAllocations;
+                Statistics::getCounter(std::string("memory.") + this->name + ".gmp_bytes") += GmpAllocator::getThreadAllocatedBytes() - this->gmpBytes;
+            }
+        }
+    };
+private:
+    static std::mutex mutex;
+    static std::map<std::string, Counter>& getCounters();
+    static void updateGmpCounters();
+public:
+    static Counter& getCounter(const std::string& name);
+
+    static void setMaximum(Counter& counter, unsigned long long value) {
+        unsigned long long current = counter.load(std::memory_order_relaxed);
+        while (current < value && !counter.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    static std::size_t bitSize(const mpz_class& a) {
+        return mpz_sizeinbase(a.get_mpz_t(), 2);
+    }
+
+    template <typename T>
+    static std::size_t bitSize(const Rational<T>& a) {
+        return std::max(bitSize(a.getNumerator()), bitSize(a.getDenominator()));
+    }
+
+    template <typename T>
+    static std::size_t bitSize(const T&) {
+        return 0;
+    }
+
+    static void reset();
+    static void print(std::ostream& s);
+    static void printJson(std::ostream& s);
+};
+
+#define STATISTICS_CONCATENATE_(a, b) a##b
+#define STATISTICS_CONCATENATE(a, b) STATISTICS_CONCATENATE_(a, b)
+
+#ifdef CFL_STATISTICS
+#define STATISTICS_ENABLED true
+// measures the time until the end of the enclosing scope
+#define STATISTICS_TIMER(name) \
+    static Statistics::Counter& STATISTICS_CONCATENATE(statisticsTime, __LINE__) = Statistics::getCounter(std::string("time.") + name + ".ns"); \
+    static Statistics::Counter& STATISTICS_CONCATENATE(statisticsCalls, __LINE__) = Statistics::getCounter(std::string("time.") + name + ".calls"); \
+    Statistics::Timer STATISTICS_CONCATENATE(statisticsTimer, __LINE__)(name, STATISTICS_CONCATENATE(statisticsTime, __LINE__), STATISTICS_CONCATENATE(statisticsCalls, __LINE__))
+#define STATISTICS_ADD(name, value) do { \
+        static Statistics::Counter& counter = Statistics::getCounter(name); \
+        counter.fetch_add(value, std::memory_order_relaxed); \
+    } while (false)
+#define STATISTICS_SET(name, value) do { \
+        static Statistics::Counter& counter = Statistics::getCounter(name); \
+        counter.store(value, std::memory_order_relaxed); \
+    } while (false)
+#define STATISTICS_MAX(name, value) do { \
+        static Statistics::Counter& counter = Statistics::getCounter(name); \
+        Statistics::setMaximum(counter, value); \
+    } while (false)
+#else
+#define STATISTICS_ENABLED false
+#define STATISTICS_TIMER(name) do {} while (false)
+#define STATISTICS_ADD(name, value) do {} while (false)
+#define STATISTICS_SET(name, value) do {} while (false)
+#define STATISTICS_MAX(name, value) do {} while (false)
+#endif
+
+#endif //STATISTICS_H
@@ -0,0 +1,12 @@
+#ifndef UNSORTED_WORD_LIST_EXCEPTION_H
+#define UNSORTED_WORD_LIST_EXCEPTION_H
+
+#include <exception>
+
+struct UnsortedWordListException : public std::exception {
+   const char* what() const noexcept override {
+      return "Error: Words of the list are not sorted.\n";
+   }
+};
+
+#endif //UNSORTED_WORD_LIST_EXCEPTION_H
@@ -0,0 +1,20 @@
+#ifndef VECTOR_HASH_H
+#define VECTOR_HASH_H
+
+#include <cstddef>
+#include <vector>
+
+// Hash of a vector of integers, e.g. a sorted subset of states, for unordered containers and
+// ShardedTable.
+template <typename T>
+struct VectorHash {
+    std::size_t operator () (const std::vector<T>& v) const {
+        std::size_t h = v.size();
+        for (T i : v) {
+            h ^= (std::size_t) i + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+};
+
+#endif //VECTOR_HASH_H
@@ -0,0 +1,129 @@
+#ifndef WORD_COUNTS_H
+#define WORD_COUNTS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <gmpxx.h>
+#include "CompiledDFA.h"
+#include "OverflowException.h"
+#include "InvalidRankException.h"
+#include "Statistics.h"
+
+template <typename T>
+inline void addCount(T& a, const T& b) {
+    T sum = a + b;
+    if (sum < a) {
+        throw OverflowException();
+    }
+    a = sum;
+}
+
+inline void addCount(mpz_class& a, const mpz_class& b) {
+    a += b;
+}
+
+// Table of c[length][state], the number of words of the given length leading from the state to
+// an acceptable one, for all lengths up to maximumLength. T is integer (mpz_class) or an unsigned
+// machine type, which is checked for overflow. The table is built once and only read afterwards,
+// so one object can be shared by many threads.
+//
+// Words of one length are ordered lexicographically by their symbols. rank and unrank take
+// O(n * |alphabet|) additions or comparisons.
+template <typename T>
+class WordCounts {
+private:
+    const CompiledDFA& dfa;
+    unsigned int maximumLength;
+    std::size_t rowSize;
+    std::vector<T> counts;
+public:
+    WordCounts(const CompiledDFA& _dfa, unsigned int _maximumLength) : dfa(_dfa), maximumLength(_maximumLength) {
+        STATISTICS_TIMER("wordCounts");
+        // the row of a length also has an entry for the dead state, which stays 0
+        this->rowSize = (std::size_t) _dfa.getNumberOfStates() + 1;
+        this->counts.assign(this->rowSize * (_maximumLength + 1), T(0));
+        for (std::uint32_t q = 0; q < _dfa.getNumberOfStates(); ++q) {
+            if (_dfa.isAcceptable(q)) {
+                this->counts[q] = 1;
+            }
+        }
+        std::uint32_t numberOfSymbols = _dfa.getAlphabetSize();
+        for (unsigned int length = 1; length <= _maximumLength; ++length) {
+            const T* previous = &this->counts[(length - 1) * this->rowSize];
+            T* current = &this->counts[length * this->rowSize];
+            for (std::uint32_t q = 0; q < _dfa.getNumberOfStates(); ++q) {
+                for (std::uint32_t column = 0; column < numberOfSymbols; ++column) {
+                    addCount(current[q], previous[_dfa.nextByColumn(q, column)]);
+                }
+            }
+        }
+    }
+
+    unsigned int getMaximumLength() const {
+        return this->maximumLength;
+    }
+
+    // number of words of the given length leading from the state to an acceptable one
+    const T& count(std::uint32_t state, unsigned int length) const {
+        return this->counts[length * this->rowSize + state];
+    }
+
+    // number of words of the given length in the language
+    const T& getNumberOfWords(unsigned int length) const {
+        if (length > this->maximumLength) {
+            throw InvalidRankException();
+        }
+        return this->count(this->dfa.getStartState(), length);
+    }
+
+    // number of words of the language of the same length smaller than the given one, which does
+    // not have to belong to the language
+    T rank(const std::string& word) const {
+        if (word.size() > this->maximumLength) {
+            throw InvalidRankException();
+        }
+        T result = 0;
+        std::uint32_t state = this->dfa.getStartState();
+        std::uint32_t numberOfSymbols = this->dfa.getAlphabetSize();
+        for (std::size_t i = 0; i < word.size() && state != this->dfa.getDeadState(); ++i) {
+            unsigned int remaining = word.size() - i - 1;
+            for (std::uint32_t column = 0; column < numberOfSymbols && (unsigned char) this->dfa.getSymbol(column) < (unsigned char) word[i]; ++column) {
+                result += this->count(this->dfa.nextByColumn(state, column), remaining);
+            }
+            state = this->dfa.next(state, word[i]);
+        }
+        return result;
+    }
+
+    // the word of the language of the given length with rank k, counting from 0
+    std::string unrank(unsigned int length, const T& k) const {
+        std::string result(length, '\0');
+        this->unrank(length, k, &result[0]);
+        return result;
+    }
+
+    // writes the word with rank k into the buffer, which has room for length symbols
+    void unrank(unsigned int length, T k, char* result) const {
+        if (length > this->maximumLength || !(k < this->count(this->dfa.getStartState(), length))) {
+            throw InvalidRankException();
+        }
+        std::uint32_t state = this->dfa.getStartState();
+        std::uint32_t numberOfSymbols = this->dfa.getAlphabetSize();
+        for (unsigned int i = 0; i < length; ++i) {
+            unsigned int remaining = length - i - 1;
+            for (std::uint32_t column = 0; column < numberOfSymbols; ++column) {
+                std::uint32_t next = this->dfa.nextByColumn(state, column);
+                const T& c = this->count(next, remaining);
+                if (k < c) {
+                    result[i] = this->dfa.getSymbol(column);
+                    state = next;
+                    break;
+                }
+                k -= c;
+            }
+        }
+    }
+};
+
+#endif //WORD_COUNTS_H
@@ -0,0 +1,105 @@
+#include <cstring>
+#include "WordEnumerator.h"
+
+WordEnumerator::WordEnumerator(const CompiledDFA& _dfa, unsigned int _length) : dfa(_dfa), length(_length) {
+    // the dead state has an entry too, so it is never a special case
+    this->rowSize = (std::size_t) _dfa.getNumberOfStates() + 1;
+    this->alive.assign(this->rowSize * (_length + 1), 0);
+    for (std::uint32_t q = 0; q < _dfa.getNumberOfStates(); ++q) {
+        this->alive[q] = _dfa.isAcceptable(q);
+    }
+    for (unsigned int remaining = 1; remaining <= _length; ++remaining) {
+        for (std::uint32_t q = 0; q < _dfa.getNumberOfStates(); ++q) {
+            for (std::uint32_t column = 0; column < _dfa.getAlphabetSize() && !this->alive[remaining * this->rowSize + q]; ++column) {
+                this->alive[remaining * this->rowSize + q] = this->isAlive(_dfa.nextByColumn(q, column), remaining - 1);
+            }
+        }
+    }
+    this->states.assign(_length + 1, 0);
+    this->columns.assign(_length, 0);
+    this->word.assign(_length, '\0');
+    this->reset();
+}
+
+bool WordEnumerator::isAlive(std::uint32_t state, unsigned int remaining) const {
+    return this->alive[remaining * this->rowSize + state];
+}
+
+// chooses the smallest symbols from the given position on, the state there has to be alive
+void WordEnumerator::fill(unsigned int position) {
+    for (unsigned int i = position; i < this->length; ++i) {
+        std::uint32_t column = 0;
+        while (!this->isAlive(this->dfa.nextByColumn(this->states[i], column), this->length - i - 1)) {
+            ++column;
+        }
+        this->columns[i] = column;
+        this->word[i] = this->dfa.getSymbol(column);
+        this->states[i + 1] = this->dfa.nextByColumn(this->states[i], column);
+    }
+}
+
+bool WordEnumerator::advance() {
+    // the last position with a larger symbol that can still be completed is increased
+    for (unsigned int i = this->length; i-- > 0;) {
+        for (std::uint32_t column = this->columns[i] + 1; column < this->dfa.getAlphabetSize(); ++column) {
+            std::uint32_t next = this->dfa.nextByColumn(this->states[i], column);
+            if (this->isAlive(next, this->length - i - 1)) {
+                this->columns[i] = column;
+                this->word[i] = this->dfa.getSymbol(column);
+                this->states[i + 1] = next;
+                this->fill(i + 1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+unsigned int WordEnumerator::getLength() const {
+    return this->length;
+}
+
+void WordEnumerator::reset() {
+    this->states[0] = this->dfa.getStartState();
+    this->hasWord = this->isAlive(this->states[0], this->length);
+    if (this->hasWord) {
+        this->fill(0);
+    }
+}
+
+bool WordEnumerator::seek(const std::string& _word) {
+    this->hasWord = false;
+    if (_word.size() != this->length) {
+        return false;
+    }
+    this->states[0] = this->dfa.getStartState();
+    for (unsigned int i = 0; i < this->length; ++i) {
+        this->columns[i] = this->dfa.getColumn(_word[i]);
+        this->states[i + 1] = this->dfa.nextByColumn(this->states[i], this->columns[i]);
+    }
+    if (!this->dfa.isAcceptable(this->states[this->length])) {
+        return false;
+    }
+    this->word = _word;
+    this->hasWord = true;
+    return true;
+}
+
+bool WordEnumerator::next(char* buffer) {
+    if (!this->hasWord) {
+        return false;
+    }
+    std::memcpy(buffer, this->word.data(), this->length);
+    this->hasWord = this->advance();
+    return true;
+}
+
+std::size_t WordEnumerator::next(char* buffer, std::size_t size) {
+    std::size_t written = 0;
+    while (this->hasWord && written + this->length + 1 <= size) {
+        this->next(buffer + written);
+        written += this->length;
+        buffer[written++] = '\n';
+    }
+    return written;
+}
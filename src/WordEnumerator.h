@@ -0,0 +1,53 @@
+#ifndef WORD_ENUMERATOR_H
+#define WORD_ENUMERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CompiledDFA.h"
+#include "WordCounts.h"
+
+// Iterator over all words of the language of one length in lexicographic order. The current
+// word is kept as the path of states and columns of fixed size, and a table of which states
+// can still reach an acceptable state in the remaining number of steps makes every step skip
+// dead branches. After construction nothing is allocated: words are copied into buffers
+// given by the caller.
+class WordEnumerator {
+private:
+    const CompiledDFA& dfa;
+    unsigned int length;
+    std::size_t rowSize;
+    // alive[remaining * rowSize + state]
+    std::vector<std::uint8_t> alive;
+    // states[i] is the state after the first i symbols of the current word
+    std::vector<std::uint32_t> states;
+    std::vector<std::uint32_t> columns;
+    std::string word;
+    bool hasWord = false;
+    bool isAlive(std::uint32_t state, unsigned int remaining) const;
+    void fill(unsigned int position);
+    bool advance();
+public:
+    WordEnumerator(const CompiledDFA& dfa, unsigned int length);
+    unsigned int getLength() const;
+    // goes back to the first word
+    void reset();
+    // continues from the given word, returns false if it does not belong to the language
+    bool seek(const std::string& word);
+    // continues from the word with the given rank, for splitting the words between workers
+    template <typename T>
+    bool seek(const WordCounts<T>& counts, const T& rank) {
+        if (!(rank < counts.getNumberOfWords(this->length))) {
+            this->hasWord = false;
+            return false;
+        }
+        return this->seek(counts.unrank(this->length, rank));
+    }
+    // writes the next word (length symbols, no terminator), returns false after the last word
+    bool next(char* buffer);
+    // writes as many next words followed by '\n' as fit into the buffer, returns the number of
+    // bytes written, 0 after the last word or if the buffer is too small for one word
+    std::size_t next(char* buffer, std::size_t size);
+};
+
+#endif //WORD_ENUMERATOR_H
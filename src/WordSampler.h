@@ -0,0 +1,93 @@
+#ifndef WORD_SAMPLER_H
+#define WORD_SAMPLER_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <gmpxx.h>
+#include "WordCounts.h"
+#include "Parallel.h"
+
+// Source of uniform numbers in [0, n) for the counter type of WordCounts.
+template <typename T>
+class UniformRank {
+private:
+    std::mt19937_64 generator;
+public:
+    UniformRank(unsigned long long seed, unsigned long long stream) {
+        std::seed_seq sequence = {(std::uint32_t) seed, (std::uint32_t) (seed >> 32), (std::uint32_t) stream, (std::uint32_t) (stream >> 32)};
+        this->generator.seed(sequence);
+    }
+
+    T below(T n) {
+        // numbers below the threshold would make the remainder biased
+        std::uint64_t threshold = -(std::uint64_t) n % (std::uint64_t) n;
+        std::uint64_t x;
+        do {
+            x = this->generator();
+        } while (x < threshold);
+        return x % n;
+    }
+};
+
+template <>
+class UniformRank<mpz_class> {
+private:
+    gmp_randclass generator;
+public:
+    UniformRank(unsigned long long seed, unsigned long long stream) : generator(gmp_randinit_default) {
+        // mpz_class has no constructor from unsigned long long, the halves are combined
+        mpz_class s = (unsigned long) (seed >> 32);
+        s <<= 32;
+        s += (unsigned long) (seed & 0xffffffff);
+        s <<= 64;
+        s += (unsigned long) (stream & 0xffffffff);
+        this->generator.seed(s);
+    }
+
+    mpz_class below(const mpz_class& n) {
+        return this->generator.get_z_range(n);
+    }
+};
+
+// Exactly uniform sampling of words of one length: a rank is drawn uniformly among the number
+// of words and unranked, so sparse languages cost the same as dense ones and nothing is
+// rejected. Every thread of sample() has its own random stream derived from the seed, so the
+// result depends only on the seed and the number of threads.
+template <typename T>
+class WordSampler {
+private:
+    const WordCounts<T>& counts;
+    unsigned long long seed;
+public:
+    WordSampler(const WordCounts<T>& _counts, unsigned long long _seed) : counts(_counts), seed(_seed) {}
+
+    // writes numberOfWords words of the given length, each followed by '\n', into the buffer
+    // of numberOfWords * (length + 1) bytes
+    void sample(unsigned int length, std::size_t numberOfWords, char* buffer, unsigned int numberOfThreads) const {
+        const T& total = this->counts.getNumberOfWords(length);
+        if (!(0 < total)) {
+            throw InvalidRankException();
+        }
+        Parallel::run(numberOfThreads, [&](unsigned int t) {
+            UniformRank<T> random(this->seed, t);
+            std::size_t end = numberOfWords * (t + 1) / numberOfThreads;
+            for (std::size_t i = numberOfWords * t / numberOfThreads; i < end; ++i) {
+                char* word = buffer + i * (length + 1);
+                this->counts.unrank(length, random.below(total), word);
+                word[length] = '\n';
+            }
+        });
+    }
+
+    std::string sample(unsigned int length, UniformRank<T>& random) const {
+        const T& total = this->counts.getNumberOfWords(length);
+        if (!(0 < total)) {
+            throw InvalidRankException();
+        }
+        return this->counts.unrank(length, random.below(total));
+    }
+};
+
+#endif //WORD_SAMPLER_H
@@ -0,0 +1,258 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "NFA.h"
+#include "DFA.h"
+#include "RationalFunction.h"
+#include "ExtendedRationalFunction.h"
+#include "LengthQuery.h"
+#include "Regex.h"
+#include "Matcher.h"
+#include "LazyDFA.h"
+#include "Parallel.h"
+#include "Statistics.h"
+#include "GmpAllocator.h"
+
+// Runs every regular expression of the corpus through all stages of the pipeline and prints
+// one JSON object per line with the timings and sizes of the intermediate results.
+
+static std::string escape(const std::string& s) {
+    std::string result;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            result.push_back('\\');
+        }
+        result.push_back(c);
+    }
+    return result;
+}
+
+static int degree(const Polynomial<Rational<integer>>& a) {
+    return (int) a.getCoefficients().size() - 1;
+}
+
+static std::size_t maxCoefficientBits(const Polynomial<Rational<integer>>& a) {
+    std::size_t result = 0;
+    for (const auto& c : a.getCoefficients()) {
+        result = std::max(result, mpz_sizeinbase(c.getNumerator().get_mpz_t(), 2));
+        result = std::max(result, mpz_sizeinbase(c.getDenominator().get_mpz_t(), 2));
+    }
+    return result;
+}
+
+// newline separated random words over the letters of the expression, of lengths up to 24
+static std::string randomWords(const std::string& regex, unsigned int numberOfWords) {
+    std::string letters;
+    for (char c : regex) {
+        if (c != '(' && c != ')' && c != '+' && c != '*' && letters.find(c) == std::string::npos) {
+            letters.push_back(c);
+        }
+    }
+    std::string result;
+    if (letters.empty()) {
+        return result;
+    }
+    std::mt19937 generator(12345);
+    for (unsigned int i = 0; i < numberOfWords; ++i) {
+        unsigned int length = generator() % 25;
+        for (unsigned int j = 0; j < length; ++j) {
+            result.push_back(letters[generator() % letters.size()]);
+        }
+        result.push_back('\n');
+    }
+    return result;
+}
+
+static void run(const std::string& name, std::string regex, unsigned int numberOfThreads, bool useGmpArena, bool useSimplification, bool useReduction, std::ostream& out) {
+    std::unique_ptr<GmpAllocator::Arena> arena(useGmpArena ? new GmpAllocator::Arena() : nullptr);
+    typedef std::chrono::steady_clock clock;
+    std::ostringstream times;
+    auto stage = [&times](const char* stageName, clock::time_point begin) {
+        times << (times.tellp() > 0 ? ", " : "") << "\"" << stageName << "\": "
+              << std::chrono::duration<double, std::milli>(clock::now() - begin).count();
+    };
+    out << "{\"name\": \"" << escape(name) << "\", \"regex_length\": " << regex.size()
+        << ", \"threads\": " << numberOfThreads;
+
+    // the pipeline runs on the simplified expression, the states of the automaton of the
+    // original one show the effect of the simplification
+    auto begin = clock::now();
+    if (useSimplification) {
+        Regex* tree = Regex::parse(regex);
+        if (tree != nullptr) {
+            NFA* original = NFA::regexToAutomaton(regex);
+            begin = clock::now();
+            tree = Regex::simplify(tree);
+            regex = tree->toString();
+            delete tree;
+            out << ", \"original_nfa_states\": " << original->getNumberOfStates() << ", \"simplified_length\": " << regex.size();
+        }
+    }
+    stage("simplify", begin);
+
+    // the symbolic method is timed separately, the automaton pipeline below runs in any case
+    begin = clock::now();
+    Regex* symbolic = Regex::parse(regex);
+    bool unambiguous = symbolic != nullptr && symbolic->isUnambiguous();
+    if (unambiguous) {
+        symbolic->getGeneratingFunction();
+    }
+    stage("symbolic", begin);
+    delete symbolic;
+    out << ", \"unambiguous\": " << (unambiguous ? "true" : "false");
+
+    begin = clock::now();
+    NFA* nfa = NFA::regexToAutomaton(regex);
+    stage("regexToAutomaton", begin);
+    if (nfa == nullptr) {
+        out << ", \"error\": \"invalid regular expression\"}\n";
+        return;
+    }
+    out << ", \"nfa_states\": " << nfa->getNumberOfStates() << ", \"nfa_transitions\": " << nfa->getNumberOfTransitions();
+
+    begin = clock::now();
+    nfa->removeEpsilonTransitions();
+    stage("removeEpsilonTransitions", begin);
+    out << ", \"epsilon_free_states\": " << nfa->getNumberOfStates() << ", \"epsilon_free_transitions\": " << nfa->getNumberOfTransitions();
+
+    if (useReduction) {
+        begin = clock::now();
+        nfa->reduce();
+        stage("reduce", begin);
+        out << ", \"reduced_states\": " << nfa->getNumberOfStates() << ", \"reduced_transitions\": " << nfa->getNumberOfTransitions();
+    }
+
+    // the matcher builds its own DFA only while it stays small and simulates the NFA otherwise
+    std::string words = randomWords(regex, 10000);
+    begin = clock::now();
+    Matcher matcher(nfa, numberOfThreads);
+    unsigned long long matchedWords = matcher.count(words.data(), words.size(), numberOfThreads);
+    stage("match", begin);
+    out << ", \"matcher_deterministic\": " << (matcher.isDeterministic() ? "true" : "false") << ", \"matched_words\": " << matchedWords;
+
+    // the same words through the LazyDFA, which the matcher uses only for large automata
+    begin = clock::now();
+    LazyDFA lazy(nfa);
+    std::vector<LazyDFA::Word> buffer;
+    unsigned long long lazyMatchedWords = 0;
+    for (std::size_t position = 0, end; position < words.size(); position = end + 1) {
+        end = words.find('\n', position);
+        lazyMatchedWords += lazy.regexMatch(words.data() + position, end - position, buffer);
+    }
+    stage("lazyMatch", begin);
+    out << ", \"lazy_dfa_states\": " << lazy.getNumberOfStates() << ", \"lazy_matched_words\": " << lazyMatchedWords;
+
+    begin = clock::now();
+    DFA* dfa = nfa->toDFA(numberOfThreads);
+    stage("toDFA", begin);
+    out << ", \"dfa_states\": " << dfa->getNumberOfStates() << ", \"dfa_transitions\": " << dfa->getNumberOfTransitions();
+
+    begin = clock::now();
+    dfa = dfa->minimize(numberOfThreads);
+    stage("minimize", begin);
+    out << ", \"minimal_states\": " << dfa->getNumberOfStates() << ", \"minimal_transitions\": " << dfa->getNumberOfTransitions();
+
+    begin = clock::now();
+    RationalFunction<Rational<integer>> f = dfa->getGeneratingFunction();
+    stage("getGeneratingFunction", begin);
+    out << ", \"numerator_degree\": " << degree(f.getNumerator()) << ", \"denominator_degree\": " << degree(f.getDenominator())
+        << ", \"max_coefficient_bits\": " << std::max(maxCoefficientBits(f.getNumerator()), maxCoefficientBits(f.getDenominator()));
+
+    begin = clock::now();
+    ExtendedRationalFunction<integer> e(f);
+    stage("ExtendedRationalFunction", begin);
+    out << ", \"denominator_factors\": " << e.getDenominator().size();
+
+    // the counts of the first lengths as targets, the minimum lengths are checked against a scan
+    begin = clock::now();
+    LengthQuery query(f, e);
+    std::vector<integer> counts;
+    for (unsigned long long n = 0; n < 32; ++n) {
+        counts.push_back(query.count(n));
+    }
+    unsigned int mismatches = 0;
+    for (const integer& target : counts) {
+        long long expected = std::find_if(counts.begin(), counts.end(), [&target](const integer& c) { return c >= target; }) - counts.begin();
+        if (query.minimumLength(target) != expected) {
+            ++mismatches;
+        }
+    }
+    stage("minimumLength", begin);
+    out << ", \"min_length_mismatches\": " << mismatches;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    out << ", \"time_ms\": {" << times.str() << "}, \"peak_rss_kb\": " << usage.ru_maxrss;
+    if (STATISTICS_ENABLED) {
+        out << ", \"statistics\": ";
+        Statistics::printJson(out);
+    }
+    out << "}\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string corpusPath = "bench_corpus.txt";
+    std::string filter;
+    unsigned int numberOfThreads = Parallel::getDefaultNumberOfThreads();
+    bool useGmpArena = false;
+    bool useSimplification = true;
+    bool useReduction = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument.compare(0, 10, "--threads=") == 0) {
+            numberOfThreads = std::max(1, std::stoi(argument.substr(10)));
+        } else if (argument == "--gmp-arena") {
+            useGmpArena = true;
+        } else if (argument == "--no-simplify") {
+            useSimplification = false;
+        } else if (argument == "--no-reduce") {
+            useReduction = false;
+        } else if (argument.compare(0, 9, "--filter=") == 0) {
+            filter = argument.substr(9);
+        } else {
+            corpusPath = argument;
+        }
+    }
+    // the allocator only counts unless --gmp-arena is given, it has to be installed before GMP is used
+    GmpAllocator::install();
+    std::ifstream corpus(corpusPath);
+    if (!corpus) {
+        std::cerr << "Cannot open " << corpusPath << "\n";
+        return -1;
+    }
+    std::string line;
+    while (std::getline(corpus, line)) {
+        std::size_t tab = line.find('\t');
+        if (line.empty() || line[0] == '#' || tab == std::string::npos) {
+            continue;
+        }
+        std::string name = line.substr(0, tab);
+        if (name.find(filter) == std::string::npos) {
+            continue;
+        }
+        // every expression runs in its own process, so that peak RSS is measured separately
+        std::cout.flush();
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::ostringstream result;
+            run(name, line.substr(tab + 1), numberOfThreads, useGmpArena, useSimplification, useReduction, result);
+            std::cout << result.str();
+            std::cout.flush();
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cout << "{\"name\": \"" << escape(name) << "\", \"error\": \"terminated abnormally\"}" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -1,37 +1,588 @@
 #include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <random>
 
 #include "NFA.h"
 #include "DFA.h"
 #include "RationalFunction.h"
 #include "ExtendedRationalFunction.h"
+#include "GeneratingFunctionCache.h"
+#include "CompiledDFA.h"
+#include "Matcher.h"
+#include "WordCounts.h"
+#include "WordEnumerator.h"
+#include "WordSampler.h"
+#include "Asymptotics.h"
+#include "LengthQuery.h"
+#include "Regex.h"
+#include "RegexDag.h"
+#include "DictionaryAutomaton.h"
+#include "IncrementalDictionary.h"
+#include "LevenshteinAutomaton.h"
+#include "LanguageComparison.h"
+#include "Parallel.h"
+#include "Statistics.h"
+#include "GmpAllocator.h"
+#include "InvalidFileException.h"
+#include "UnsortedWordListException.h"
 
-int main() {
-    std::string regex;
-    std::cout << "Podaj wyrażenie regularne: ";
-    std::cin >> regex;
+static std::pair<GeneratingFunctionCache::Function, GeneratingFunctionCache::ExtendedFunction> withExtendedForm(const GeneratingFunctionCache::Function& f) {
+    return {f, GeneratingFunctionCache::ExtendedFunction(f)};
+}
 
+// a number of words given in decimal or as a power like 2^64
+static integer parseTarget(const std::string& s) {
+    std::size_t caret = s.find('^');
+    if (caret == std::string::npos) {
+        return integer(s);
+    }
+    integer result;
+    mpz_pow_ui(result.get_mpz_t(), integer(s.substr(0, caret)).get_mpz_t(), std::stoul(s.substr(caret + 1)));
+    return result;
+}
+
+// nullptr if the expression is not valid
+static NFA* toEpsilonFreeAutomaton(const std::string& regex) {
     NFA* nfa = NFA::regexToAutomaton(regex);
-    if (nfa == nullptr) {
-        std::cerr << "Wyrażenie regularne nie jest prawidłowe\n";
+    if (nfa != nullptr) {
+        nfa->removeEpsilonTransitions();
+    }
+    return nfa;
+}
+
+// -1 if the word list cannot be read
+static int matchWords(const Matcher& matcher, const std::string& path, bool printOffsets, unsigned int numberOfThreads) {
+    try {
+        if (printOffsets) {
+            for (std::uint64_t offset : matcher.findInFile(path, numberOfThreads)) {
+                std::cout << offset << "\n";
+            }
+        } else {
+            unsigned long long count = matcher.countFile(path, numberOfThreads);
+            std::cout << "Liczba pasujących słów: " << count << "\n";
+        }
+    } catch (const InvalidFileException&) {
+        std::cerr << "Plik " << path << " nie może zostać odczytany\n";
         return -1;
     }
+    return 0;
+}
+
+// the generating function of a finite language, a polynomial
+static GeneratingFunctionCache::Function toPolynomial(const std::vector<integer>& counts) {
+    std::vector<Rational<integer>> coefficients;
+    for (const integer& count : counts) {
+        coefficients.emplace_back(count);
+    }
+    return GeneratingFunctionCache::Function(coefficients);
+}
 
-//    std::cout << "NFA z \u03B5-przejściami:\n";
-//    nfa->print();
-    nfa->removeEpsilonTransitions();
- //   std::cout << "\n\nNFA bez \u03B5-przejść:\n";
-//    nfa->print();
-    DFA* dfa = nfa->toDFA();
-//    std::cout << "\n\nDFA:\n";
-//    dfa->print();
-    dfa = dfa->minimize();
-//    std::cout << "\n\nZminimalizowany DFA:\n";
-//    dfa->print();
+static std::string toDecimal(const Rational<integer>& a) {
+    std::ostringstream s;
+    s << std::setprecision(22) << mpf_class(mpq_class(a.getNumerator(), a.getDenominator()), 128);
+    return s.str();
+}
+
+static void printAllStatistics(bool printStatistics, bool printStatisticsAsJson) {
+    if ((printStatistics || printStatisticsAsJson) && !STATISTICS_ENABLED) {
+        std::cerr << "Statystyki nie zostały wkompilowane (make STATISTICS=1)\n";
+    } else if (printStatistics) {
+        std::cout << "Statystyki:\n";
+        Statistics::print(std::cout);
+    } else if (printStatisticsAsJson) {
+        Statistics::printJson(std::cout);
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // GMP memory functions can only be replaced before the first number is allocated, and some
+    // of the options below are numbers themselves
+    bool useGmpArena = std::find(argv + 1, argv + argc, std::string("--gmp-arena")) != argv + argc;
+    if (useGmpArena) {
+        GmpAllocator::install();
+    }
+    std::string cacheDirectory;
+    std::string savePath;
+    std::string loadPath;
+    std::string wordsPath;
+    std::string avoidPath;
+    std::string updatePath;
+    std::vector<std::string> policyPaths;
+    std::string batchPath;
+    std::string alphabet;
+    int editDistance = 0;
+    std::string matchPath;
+    std::string equalRegex;
+    std::string supersetRegex;
+    bool printMatchOffsets = false;
+    int maximumLength = -1;
+    std::vector<std::string> wordsToRank;
+    std::vector<std::pair<unsigned int, integer>> ranksToUnrank;
+    int enumeratedLength = -1;
+    integer firstRank = 0;
+    integer lastRank = -1;
+    int sampledLength = -1;
+    std::size_t numberOfSamples = 0;
+    unsigned long long seed = std::random_device()();
+    bool printAsymptotics = false;
+    std::vector<unsigned long long> approximatedLengths;
+    std::vector<integer> targets;
+    std::vector<integer> cumulativeTargets;
+    unsigned int numberOfThreads = Parallel::getDefaultNumberOfThreads();
+    bool printStatistics = false;
+    bool printStatisticsAsJson = false;
+    bool useSymbolicMethod = true;
+    bool useSimplification = true;
+    bool useReduction = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        // numbers that cannot be parsed throw std::invalid_argument or std::out_of_range
+        try {
+            if (argument.compare(0, 8, "--cache=") == 0) {
+                cacheDirectory = argument.substr(8);
+            } else if (argument.compare(0, 7, "--save=") == 0) {
+                savePath = argument.substr(7);
+            } else if (argument.compare(0, 7, "--load=") == 0) {
+                loadPath = argument.substr(7);
+            } else if (argument.compare(0, 8, "--words=") == 0) {
+                wordsPath = argument.substr(8);
+            } else if (argument.compare(0, 9, "--update=") == 0) {
+                updatePath = argument.substr(9);
+            } else if (argument.compare(0, 9, "--policy=") == 0) {
+                policyPaths.push_back(argument.substr(9));
+            } else if (argument.compare(0, 8, "--batch=") == 0) {
+                batchPath = argument.substr(8);
+            } else if (argument.compare(0, 8, "--avoid=") == 0) {
+                avoidPath = argument.substr(8);
+            } else if (argument.compare(0, 11, "--alphabet=") == 0) {
+                alphabet = argument.substr(11);
+            } else if (argument.compare(0, 16, "--edit-distance=") == 0) {
+                editDistance = std::max(0, std::stoi(argument.substr(16)));
+            } else if (argument.compare(0, 9, "--equals=") == 0) {
+                equalRegex = argument.substr(9);
+            } else if (argument.compare(0, 12, "--subset-of=") == 0) {
+                supersetRegex = argument.substr(12);
+            } else if (argument.compare(0, 8, "--match=") == 0) {
+                matchPath = argument.substr(8);
+            } else if (argument == "--match-offsets") {
+                printMatchOffsets = true;
+            } else if (argument.compare(0, 8, "--count=") == 0) {
+                maximumLength = std::max(0, std::stoi(argument.substr(8)));
+            } else if (argument.compare(0, 7, "--rank=") == 0) {
+                wordsToRank.push_back(argument.substr(7));
+            } else if (argument.compare(0, 9, "--unrank=") == 0 && argument.find(',') != std::string::npos) {
+                std::size_t comma = argument.find(',');
+                int length = std::stoi(argument.substr(9, comma - 9));
+                if (length < 0) {
+                    std::cerr << "Nieprawidłowa wartość opcji: " << argument << "\n";
+                    return -1;
+                }
+                ranksToUnrank.emplace_back(length, integer(argument.substr(comma + 1)));
+            } else if (argument.compare(0, 12, "--enumerate=") == 0) {
+                // --enumerate=N or --enumerate=N,K1,K2 for the words with ranks in [K1, K2)
+                std::size_t comma = argument.find(',');
+                enumeratedLength = std::max(0, std::stoi(argument.substr(12, comma == std::string::npos ? std::string::npos : comma - 12)));
+                if (comma != std::string::npos) {
+                    std::size_t secondComma = argument.find(',', comma + 1);
+                    firstRank = integer(argument.substr(comma + 1, secondComma == std::string::npos ? std::string::npos : secondComma - comma - 1));
+                    if (secondComma != std::string::npos) {
+                        lastRank = integer(argument.substr(secondComma + 1));
+                    }
+                }
+            } else if (argument.compare(0, 9, "--sample=") == 0 && argument.find(',') != std::string::npos) {
+                std::size_t comma = argument.find(',');
+                sampledLength = std::max(0, std::stoi(argument.substr(9, comma - 9)));
+                numberOfSamples = std::stoull(argument.substr(comma + 1));
+            } else if (argument.compare(0, 7, "--seed=") == 0) {
+                seed = std::stoull(argument.substr(7));
+            } else if (argument == "--asymptotics") {
+                printAsymptotics = true;
+            } else if (argument.compare(0, 14, "--asymptotics=") == 0) {
+                printAsymptotics = true;
+                approximatedLengths.push_back(std::stoull(argument.substr(14)));
+            } else if (argument.compare(0, 13, "--min-length=") == 0) {
+                targets.push_back(parseTarget(argument.substr(13)));
+            } else if (argument.compare(0, 19, "--min-total-length=") == 0) {
+                cumulativeTargets.push_back(parseTarget(argument.substr(19)));
+            } else if (argument == "--stats") {
+                printStatistics = true;
+            } else if (argument == "--stats=json") {
+                printStatisticsAsJson = true;
+            } else if (argument == "--gmp-arena") {
+                // installed above
+            } else if (argument == "--no-symbolic") {
+                useSymbolicMethod = false;
+            } else if (argument == "--no-simplify") {
+                useSimplification = false;
+            } else if (argument == "--no-reduce") {
+                useReduction = false;
+            } else if (argument.compare(0, 10, "--threads=") == 0) {
+                numberOfThreads = std::max(1, std::stoi(argument.substr(10)));
+            } else {
+                std::cerr << "Nieznana opcja: " << argument << "\n";
+                return -1;
+            }
+        } catch (const std::logic_error&) {
+            std::cerr << "Nieprawidłowa wartość opcji: " << argument << "\n";
+            return -1;
+        }
+    }
+
+    if (!policyPaths.empty() && wordsPath.empty()) {
+        std::cerr << "Opcja --policy wymaga opcji --words\n";
+        return -1;
+    }
+    std::unique_ptr<GmpAllocator::Arena> arena(useGmpArena ? new GmpAllocator::Arena() : nullptr);
+
+    if (!batchPath.empty()) {
+        // one expression per line, equal subexpressions of all of them are computed once
+        RegexDag dag(numberOfThreads);
+        std::ifstream batch(batchPath);
+        std::string line;
+        while (std::getline(batch, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+            int node = dag.add(line);
+            if (node < 0 && NFA::isValidRegex(line)) {
+                // nested too deeply for a syntax tree, so not shared with the other expressions
+                NFA* nfa = toEpsilonFreeAutomaton(line);
+                std::cout << line << "\n" << nfa->toDFA(numberOfThreads)->minimize(numberOfThreads)->getGeneratingFunction() << "\n";
+                continue;
+            }
+            if (node < 0) {
+                std::cerr << "Wyrażenie regularne nie jest prawidłowe: " << line << "\n";
+                continue;
+            }
+            std::cout << line << "\n" << dag.getGeneratingFunction(node) << "\n";
+        }
+        std::cout << "Liczba różnych podwyrażeń: " << dag.getNumberOfNodes() << "\n";
+        printAllStatistics(printStatistics, printStatisticsAsJson);
+        return 0;
+    }
 
-    RationalFunction<Rational<integer>> f = dfa->getGeneratingFunction();
+    std::string regex;
+    bool readRegex = loadPath.empty() && wordsPath.empty() && avoidPath.empty();
+    if (readRegex) {
+        std::cout << "Podaj wyrażenie regularne: ";
+        std::cin >> regex;
+        // redundancies like (a*)* or (a+a) are rewritten before any automaton is built; an
+        // expression nested too deeply to be parsed into a tree is used as it is
+        Regex* tree = useSimplification ? Regex::parse(regex) : nullptr;
+        if (tree != nullptr) {
+            tree = Regex::simplify(tree);
+            std::string simplified = tree->toString();
+            delete tree;
+            if (printStatistics || printStatisticsAsJson) {
+                // the effect on states, the ε-NFAs of both expressions are built only for the statistics
+                STATISTICS_SET("simplify.nfa_states_before", NFA::regexToAutomaton(regex)->getNumberOfStates());
+                STATISTICS_SET("simplify.nfa_states_after", NFA::regexToAutomaton(simplified)->getNumberOfStates());
+            }
+            regex = simplified;
+        }
+    }
+    if (readRegex && (!equalRegex.empty() || !supersetRegex.empty())) {
+        // the languages are compared on automata which are not minimized
+        NFA* nfa = toEpsilonFreeAutomaton(regex);
+        NFA* equal = equalRegex.empty() ? nullptr : toEpsilonFreeAutomaton(equalRegex);
+        NFA* superset = supersetRegex.empty() ? nullptr : toEpsilonFreeAutomaton(supersetRegex);
+        if (nfa == nullptr || (!equalRegex.empty() && equal == nullptr) || (!supersetRegex.empty() && superset == nullptr)) {
+            std::cerr << "Wyrażenie regularne nie jest prawidłowe\n";
+            return -1;
+        }
+        std::string counterexample;
+        if (superset != nullptr) {
+            if (LanguageComparison::isIncluded(nfa, superset, counterexample)) {
+                std::cout << "Język zawiera się w " << supersetRegex << "\n";
+            } else {
+                std::cout << "Język nie zawiera się w " << supersetRegex << ", najkrótsze słowo spoza niego: \"" << counterexample << "\"\n";
+            }
+        }
+        if (equal != nullptr) {
+            if (LanguageComparison::areEquivalent(nfa->toDFA(numberOfThreads), equal->toDFA(numberOfThreads), counterexample)) {
+                std::cout << "Język jest równy " << equalRegex << "\n";
+            } else {
+                std::cout << "Język jest różny od " << equalRegex << ", najkrótsze słowo rozróżniające: \"" << counterexample << "\"\n";
+            }
+        }
+        printAllStatistics(printStatistics, printStatisticsAsJson);
+        return 0;
+    }
+
+    // an unambiguous expression gives the generating function directly, but the automaton is
+    // still needed by the options working on words; an expression nested deeper than
+    // Regex::MAXIMUM_DEPTH is not parsed and goes through the automata as well
+    Regex* symbolic = nullptr;
+    if (useSymbolicMethod && readRegex && editDistance == 0 && savePath.empty() && matchPath.empty() && maximumLength < 0 && wordsToRank.empty()
+        && ranksToUnrank.empty() && enumeratedLength < 0 && sampledLength < 0) {
+        symbolic = Regex::parse(regex);
+        if (symbolic != nullptr && !symbolic->isUnambiguous()) {
+            delete symbolic;
+            symbolic = nullptr;
+        }
+    }
+
+    DFA* dfa = nullptr;
+    // the policies have to outlive the dictionary
+    std::vector<std::unique_ptr<CompiledDFA>> policies;
+    IncrementalDictionary* dictionary = nullptr;
+    if (!loadPath.empty()) {
+        try {
+            dfa = CompiledDFA(loadPath).toDFA();
+        } catch (const InvalidFileException&) {
+            std::cerr << "Plik " << loadPath << " nie może zostać odczytany lub ma nieprawidłowy format\n";
+            return -1;
+        }
+    } else if (!wordsPath.empty()) {
+        try {
+            dfa = DictionaryAutomaton::fromSortedWords(wordsPath);
+        } catch (const InvalidFileException&) {
+            std::cerr << "Plik " << wordsPath << " nie może zostać odczytany\n";
+            return -1;
+        } catch (const UnsortedWordListException&) {
+            std::cerr << "Słowa w pliku " << wordsPath << " nie są posortowane\n";
+            return -1;
+        }
+        if (!updatePath.empty() || !policyPaths.empty()) {
+            // lines +WORD and -WORD add and remove words, keeping the automaton minimal and the
+            // numbers of words, also of those accepted by the policies, up to date
+            dictionary = new IncrementalDictionary(dfa);
+            for (const std::string& path : policyPaths) {
+                try {
+                    policies.emplace_back(new CompiledDFA(path));
+                } catch (const InvalidFileException&) {
+                    std::cerr << "Plik " << path << " nie może zostać odczytany lub ma nieprawidłowy format\n";
+                    return -1;
+                }
+                dictionary->addPolicy(*policies.back());
+            }
+            if (!updatePath.empty()) {
+                std::ifstream updates(updatePath);
+                if (!updates.is_open()) {
+                    std::cerr << "Plik " << updatePath << " nie może zostać odczytany\n";
+                    return -1;
+                }
+                std::string line;
+                unsigned int numberOfChanges = 0;
+                unsigned int numberOfInvalidLines = 0;
+                while (std::getline(updates, line)) {
+                    if (!line.empty() && line.back() == '\r') {
+                        line.pop_back();
+                    }
+                    if (line.size() > 1 && line[0] == '+') {
+                        numberOfChanges += dictionary->insert(line.substr(1));
+                    } else if (line.size() > 1 && line[0] == '-') {
+                        numberOfChanges += dictionary->remove(line.substr(1));
+                    } else if (!line.empty()) {
+                        ++numberOfInvalidLines;
+                    }
+                }
+                std::cout << "Liczba zmienionych słów: " << numberOfChanges << "\n";
+                if (numberOfInvalidLines > 0) {
+                    std::cerr << "Pominięto nieprawidłowe wiersze pliku " << updatePath << " (inne niż +słowo i -słowo): " << numberOfInvalidLines << "\n";
+                }
+            }
+            for (unsigned int i = 0; i < policies.size(); ++i) {
+                integer accepted = 0;
+                for (const integer& count : dictionary->getAcceptedCounts(i)) {
+                    accepted += count;
+                }
+                std::cout << "Liczba słów zgodnych z polityką " << policyPaths[i] << ": " << accepted << "\n";
+            }
+            dfa = dictionary->getAutomaton();
+        }
+    } else if (!avoidPath.empty()) {
+        try {
+            dfa = DictionaryAutomaton::avoidingAll(avoidPath, alphabet, numberOfThreads);
+        } catch (const InvalidFileException&) {
+            std::cerr << "Plik " << avoidPath << " nie może zostać odczytany\n";
+            return -1;
+        }
+    } else if (symbolic == nullptr) {
+        NFA* nfa = NFA::regexToAutomaton(regex);
+        if (nfa == nullptr) {
+            std::cerr << "Wyrażenie regularne nie jest prawidłowe\n";
+            return -1;
+        }
+
+//        std::cout << "NFA z \u03B5-przejściami:\n";
+//        nfa->print();
+        nfa->removeEpsilonTransitions();
+//        std::cout << "\n\nNFA bez \u03B5-przejść:\n";
+//        nfa->print();
+        if (useReduction) {
+            nfa->reduce();
+        }
+        if (!matchPath.empty() && editDistance == 0 && savePath.empty() && maximumLength < 0 && wordsToRank.empty() && ranksToUnrank.empty()
+            && enumeratedLength < 0 && sampledLength < 0 && !printAsymptotics && targets.empty() && cumulativeTargets.empty()) {
+            // nothing but matching is asked for, so the DFA is built only while it stays small
+            Matcher matcher(nfa, numberOfThreads);
+            int result = matchWords(matcher, matchPath, printMatchOffsets, numberOfThreads);
+            printAllStatistics(printStatistics, printStatisticsAsJson);
+            return result;
+        }
+        if (maximumLength >= 0 && editDistance == 0 && savePath.empty() && matchPath.empty() && wordsToRank.empty() && ranksToUnrank.empty()
+            && enumeratedLength < 0 && sampledLength < 0) {
+            // only the first coefficients are needed, so the DFA is not built
+            std::vector<integer> counts = nfa->countWords(maximumLength, numberOfThreads);
+            std::cout << "Liczby słów długości 0, ..., " << maximumLength << ":\n";
+            for (const integer& count : counts) {
+                std::cout << count << "\n";
+            }
+            printAllStatistics(printStatistics, printStatisticsAsJson);
+            return 0;
+        }
+        dfa = nfa->toDFA(numberOfThreads);
+//        std::cout << "\n\nDFA:\n";
+//        dfa->print();
+        dfa = dfa->minimize(numberOfThreads);
+//        std::cout << "\n\nZminimalizowany DFA:\n";
+//        dfa->print();
+    }
+    if (editDistance > 0) {
+        // the words within the edit distance of the language, over the letters of the language
+        // unless --alphabet is given
+        dfa = LevenshteinAutomaton::neighbourhood(dfa, editDistance, alphabet)->minimize(numberOfThreads);
+    }
+    if (!savePath.empty()) {
+        CompiledDFA(dfa).save(savePath);
+    }
+    if (!matchPath.empty()) {
+        if (matchWords(Matcher(dfa), matchPath, printMatchOffsets, numberOfThreads) != 0) {
+            return -1;
+        }
+    }
+
+    if (maximumLength >= 0) {
+        // the automaton is needed anyway or comes from elsewhere, so the counts are read from it
+        CompiledDFA compiled(dfa);
+        WordCounts<integer> counts(compiled, maximumLength);
+        std::cout << "Liczby słów długości 0, ..., " << maximumLength << ":\n";
+        for (int n = 0; n <= maximumLength; ++n) {
+            std::cout << counts.getNumberOfWords(n) << "\n";
+        }
+    }
+
+    if (!wordsToRank.empty() || !ranksToUnrank.empty()) {
+        unsigned int length = 0;
+        for (const std::string& word : wordsToRank) {
+            length = std::max(length, (unsigned int) word.size());
+        }
+        for (const auto& p : ranksToUnrank) {
+            length = std::max(length, p.first);
+        }
+        CompiledDFA compiled(dfa);
+        WordCounts<integer> counts(compiled, length);
+        for (const std::string& word : wordsToRank) {
+            std::cout << "Pozycja słowa " << word << ": " << counts.rank(word) << " z " << counts.getNumberOfWords(word.size()) << "\n";
+        }
+        for (const auto& p : ranksToUnrank) {
+            if (p.second >= 0 && p.second < counts.getNumberOfWords(p.first)) {
+                std::cout << "Słowo długości " << p.first << " na pozycji " << p.second << ": " << counts.unrank(p.first, p.second) << "\n";
+            } else {
+                std::cerr << "Nie ma słowa długości " << p.first << " na pozycji " << p.second << "\n";
+            }
+        }
+    }
+
+    if (enumeratedLength >= 0) {
+        CompiledDFA compiled(dfa);
+        WordCounts<integer> counts(compiled, enumeratedLength);
+        WordEnumerator enumerator(compiled, enumeratedLength);
+        if (lastRank < 0 || lastRank > counts.getNumberOfWords(enumeratedLength)) {
+            lastRank = counts.getNumberOfWords(enumeratedLength);
+        }
+        std::cout << "\n";
+        if (firstRank < lastRank && enumerator.seek(counts, firstRank)) {
+            std::vector<char> buffer(std::max(1 << 16, enumeratedLength + 1));
+            integer remaining = lastRank - firstRank;
+            while (remaining > 0) {
+                // full buffers are written while more words remain than fit, then one word at a time
+                std::size_t size = remaining > buffer.size() / (enumeratedLength + 1) ? buffer.size() : enumeratedLength + 1;
+                std::size_t written = enumerator.next(buffer.data(), size);
+                std::cout.write(buffer.data(), written);
+                remaining -= written / (enumeratedLength + 1);
+            }
+        }
+        printAllStatistics(printStatistics, printStatisticsAsJson);
+        return 0;
+    }
+
+    if (sampledLength >= 0) {
+        CompiledDFA compiled(dfa);
+        WordCounts<integer> counts(compiled, sampledLength);
+        std::cout << "\n";
+        if (counts.getNumberOfWords(sampledLength) == 0) {
+            std::cerr << "Język nie zawiera słów długości " << sampledLength << "\n";
+            return -1;
+        }
+        std::vector<char> buffer(numberOfSamples * (sampledLength + 1));
+        WordSampler<integer>(counts, seed).sample(sampledLength, numberOfSamples, buffer.data(), numberOfThreads);
+        std::cout.write(buffer.data(), buffer.size());
+        printAllStatistics(printStatistics, printStatisticsAsJson);
+        return 0;
+    }
+
+    if (maximumLength >= 0) {
+        // as without the automaton, the counts are the whole answer
+        printAllStatistics(printStatistics, printStatisticsAsJson);
+        return 0;
+    }
+
+    GeneratingFunctionCache cache(cacheDirectory);
+    // the dictionary has kept the numbers of its words up to date, nothing has to be recounted
+    auto f = symbolic != nullptr ? withExtendedForm(symbolic->getGeneratingFunction())
+             : dictionary != nullptr ? withExtendedForm(toPolynomial(dictionary->getCounts())) : cache.get(dfa);
     std::cout << "Funkcja tworząca:" << "\n";
-    std::cout << f << "\n";
+    std::cout << f.first << "\n";
     std::cout << "Inna postać:\n";
-    std::cout << ExtendedRationalFunction<integer>(f) << "\n";
+    std::cout << f.second << "\n";
+    if (printAsymptotics) {
+        Asymptotics asymptotics(f.second);
+        if (asymptotics.isFinite()) {
+            std::cout << "Język jest skończony\n";
+        } else {
+            std::cout << "Asymptotyka: a_n ~ C * n^" << asymptotics.getPolynomialDegree() << " * rho^(-n)";
+            if (asymptotics.getNumberOfDominantPoles() > 1) {
+                std::cout << " (" << asymptotics.getNumberOfDominantPoles() << " bieguny na okręgu |x| = rho, liczby słów oscylują)";
+            }
+            std::cout << "\n";
+            std::cout << "rho w [" << toDecimal(asymptotics.getRadius().lower) << ", " << toDecimal(asymptotics.getRadius().upper) << "]\n";
+            std::cout << "C w [" << toDecimal(asymptotics.getConstant().lower) << ", " << toDecimal(asymptotics.getConstant().upper) << "]\n";
+            std::cout << "Tempo wzrostu 1/rho: " << (double) asymptotics.getGrowthRate() << ", entropia: " << (double) asymptotics.getEntropyRate() << " bitów na symbol\n";
+        }
+        for (unsigned long long n : approximatedLengths) {
+            std::cout << "Liczba słów długości " << n << ": ~" << (double) asymptotics.approximate(n) << " +- " << (double) asymptotics.getErrorBound(n)
+                      << " (" << (double) asymptotics.getEntropy(n) << " bitów)\n";
+        }
+    }
+    if (!targets.empty() || !cumulativeTargets.empty()) {
+        LengthQuery query(f.first, f.second);
+        for (const integer& target : targets) {
+            long long n = query.minimumLength(target);
+            if (n < 0) {
+                std::cout << "Nie znaleziono długości z co najmniej " << target << " słowami\n";
+            } else {
+                std::cout << "Najmniejsza długość z co najmniej " << target << " słowami: " << n << " (" << query.count(n) << " słów)\n";
+            }
+        }
+        for (const integer& target : cumulativeTargets) {
+            long long n = query.minimumCumulativeLength(target);
+            if (n < 0) {
+                std::cout << "Nie znaleziono długości n z co najmniej " << target << " słowami długości <= n\n";
+            } else {
+                std::cout << "Najmniejsza długość n z co najmniej " << target << " słowami długości <= n: " << n << " (" << query.cumulativeCount(n) << " słów)\n";
+            }
+        }
+    }
+    printAllStatistics(printStatistics, printStatisticsAsJson);
     return 0;
 }